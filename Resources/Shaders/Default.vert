@@ -5,6 +5,7 @@ layout(location=1) in vec3 inNormal;
 layout(location=2) in vec2 inTextureCoordinates;
 
 layout(location=0) out vec2 outTextureCoordinates;
+layout(location=1) out vec3 outNormal;
 
 layout(set=0, binding=0) uniform GlobalUniform
 {
@@ -20,10 +21,26 @@ layout(set=0, binding=0) uniform GlobalUniform
 layout(push_constant) uniform Constants
 {
     mat4 model;
+    vec4 positionScale;
+    vec4 positionOffset; // w is the vertex format, 1 for compact vertices.
 } object;
 
+// Compact vertices store normals octahedral encoded, the third component reads as zero.
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main() 
 {
+    // Full vertices have a scale of one and no offset, the same path handles both.
+    vec3 position = inPosition * object.positionScale.xyz + object.positionOffset.xyz;
+    vec3 normal = object.positionOffset.w == 1.0 ? DecodeOctahedral(inNormal.xy) : inNormal;
+
     outTextureCoordinates = inTextureCoordinates;
-    gl_Position = global.projection * global.view * object.model * vec4(inPosition, 1.0);
+    outNormal = normalize(mat3(object.model) * normal);
+    gl_Position = global.projection * global.view * object.model * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include "Precompiled.h"
+
+class BakeCache;
+class ShaderCompiler;
+
+struct ResourceFile
+{
+    std::string type;
+    std::string relativePath;
+    std::filesystem::path absolutePath;
+    std::filesystem::path bakedPath; // Empty if no baking took place.
+    std::vector<std::filesystem::path> dependencies; // Other source files the bake reads, shader includes for example.
+    std::vector<std::string> references; // Other resources found while baking that the engine loads first, by manifest path.
+    nlohmann::json properties;
+};
+
+struct ProcessorState
+{
+    std::vector<ResourceFile> resources;
+    std::unordered_set<std::string> resourceChecker;
+    std::map<std::string, std::vector<std::string>> groups; // Named load groups from the manifest by source path, each laid out in one run of the pack.
+    std::filesystem::path manifestPath;
+    std::filesystem::path outputPath;
+    std::filesystem::path materialOutputPath;
+    BakeCache* cache = nullptr;
+    ShaderCompiler* shaderCompiler = nullptr;
+};
+
+// Bump a processor's version whenever the files it writes change, this invalidates
+// anything baked by the older version.
+uint32_t GetProcessorVersion(const std::string& type);
+
+// Names the library or tool a processor bakes with and its version, empty for processors
+// that only run code of their own. Part of every bake cache key, so builds configured
+// with different backends never restore each other's outputs.
+std::string GetProcessorBackend(const ProcessorState& state, const std::string& type);
+std::string GetAudioBackend();
+
+std::vector<std::filesystem::path> CollectShaderIncludes(const std::filesystem::path& shader);
+
+// Records how the engine holds the sound in "loadMode", from the manifest or the sound's length.
+bool ChooseSoundLoadMode(ResourceFile& resource);
+
+bool ProcessResource(ProcessorState& state, ResourceFile& resource);
+bool ProcessShader(ProcessorState& state, ResourceFile& resource);
+bool ProcessTexture(ProcessorState& state, ResourceFile& resource);
+bool ProcessAudio(ProcessorState& state, ResourceFile& resource);
+bool ProcessModel(ProcessorState& state, ResourceFile& resource);
@@ -0,0 +1,221 @@
+#include <mutex>
+#include <thread>
+
+#include <fmod.hpp>
+
+#ifdef BLUEMETAL_FSBANK
+#include <fsbank.h>
+#include <fsbank_errors.h>
+#endif
+
+#include "Core/Print.h"
+#include "AssetProcessor.h"
+#include "BakeReport.h"
+
+// Sounds are transcoded into FSB5 banks holding the one sound, FMOD opens them without
+// probing for a codec and they're much smaller than the FLAC or WAV they came from.
+//
+// Every sound also gets a "loadMode", how the engine asks FMOD to hold it, see Audio/Sound.h.
+//
+// Decompress  short effects, decoded to PCM once when loaded so playing them costs nothing
+// Compressed  effects and stingers too long to keep as PCM, FADPCM is cheap to decode per voice
+// Stream      music and ambience, Vorbis decoded a little at a time while it plays
+//
+// The manifest can pick one itself with "loadMode", otherwise it's picked by length.
+
+static constexpr unsigned int ShortSoundLength = 5000; // Milliseconds, anything shorter is decompressed.
+static constexpr unsigned int LongSoundLength = 30000; // Milliseconds, anything longer is streamed.
+
+static bool GetSoundLength(const std::filesystem::path& path, unsigned int& length)
+{
+    // FMOD is thread safe, every bake job measures with the same system. It never plays
+    // anything and lives until the processor exits.
+    static FMOD::System* system = []() -> FMOD::System*
+    {
+        FMOD::System* system = nullptr;
+        if (FMOD::System_Create(&system, FMOD_VERSION) != FMOD_OK)
+            return nullptr;
+
+        if (system->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT) != FMOD_OK || system->init(1, FMOD_INIT_NORMAL, nullptr) != FMOD_OK)
+        {
+            system->release();
+            return nullptr;
+        }
+
+        return system;
+    }();
+
+    if (!system)
+        return false;
+
+    // Only the header is read, nothing is decoded.
+    FMOD::Sound* sound = nullptr;
+    if (system->createSound(path.string().c_str(), FMOD_OPENONLY, nullptr, &sound) != FMOD_OK)
+        return false;
+
+    auto result = sound->getLength(&length, FMOD_TIMEUNIT_MS);
+    sound->release();
+    return result == FMOD_OK;
+}
+
+bool ChooseSoundLoadMode(ResourceFile& resource)
+{
+    auto loadMode = resource.properties.value("loadMode", "");
+
+    if (loadMode.empty())
+    {
+        BakeStageTimer timer{BakeStage::eImport};
+        unsigned int length = 0;
+        if (!GetSoundLength(resource.absolutePath, length))
+        {
+            blError("{}: Could not read the length of this sound.", resource.relativePath);
+            return false;
+        }
+
+        if (length < ShortSoundLength)
+            loadMode = "Decompress";
+        else if (length <= LongSoundLength)
+            loadMode = "Compressed";
+        else
+            loadMode = "Stream";
+
+        blVerbose("{}: {} ms long, picked {}.", resource.relativePath, length, loadMode);
+    }
+    else if (loadMode != "Decompress" && loadMode != "Compressed" && loadMode != "Stream")
+    {
+        blError("{}: Unknown load mode {}, expected Decompress, Compressed or Stream.", resource.relativePath, loadMode);
+        return false;
+    }
+
+#ifndef BLUEMETAL_FSBANK
+    // Without FSBank the source is shipped as is, FMOD can only keep a few codecs compressed in memory.
+    auto extension = resource.absolutePath.extension();
+    if (loadMode == "Compressed" && extension != ".ogg" && extension != ".mp3")
+    {
+        blWarning("{}: FSBank was not found and {} can't stay compressed in memory, it will be decompressed.", resource.relativePath, extension.string());
+        loadMode = "Decompress";
+    }
+#endif
+
+    resource.properties["loadMode"] = loadMode;
+    return true;
+}
+
+#ifdef BLUEMETAL_FSBANK
+
+// FSBank is one encoder for the whole process, banks are built one at a time.
+static std::mutex fsbankMutex;
+
+struct FSBankSession
+{
+    FSBankSession(const std::filesystem::path& cachePath)
+    {
+        // The bake cache already decides what gets rebuilt, FSBank's own cache is write only.
+        std::filesystem::create_directories(cachePath);
+        result = FSBank_Init(FSBANK_FSBVERSION_FSB5, FSBANK_INIT_DONTLOADCACHEFILES | FSBANK_INIT_GENERATEPROGRESSITEMS, std::max(std::thread::hardware_concurrency(), 1u), cachePath.string().c_str());
+    }
+
+    ~FSBankSession()
+    {
+        if (result == FSBANK_OK)
+            FSBank_Release();
+    }
+
+    FSBANK_RESULT result;
+};
+
+static bool BuildBank(const ProcessorState& state, const ResourceFile& resource, FSBANK_FORMAT format, unsigned int quality, const std::filesystem::path& exportedPath)
+{
+    BakeStageTimer timer{BakeStage::eEncode}; // Waiting on another bake's bank counts too, it's time this bake spent.
+    std::lock_guard lock{fsbankMutex};
+
+    static FSBankSession session{state.outputPath / ".fsbank"};
+    if (session.result != FSBANK_OK)
+    {
+        blError("{}: Could not start FSBank, {}", resource.relativePath, FSBank_ErrorString(session.result));
+        return false;
+    }
+
+    auto sourcePath = resource.absolutePath.string();
+    const char* fileName = sourcePath.c_str();
+
+    FSBANK_SUBSOUND subSound{};
+    subSound.fileNames = &fileName;
+    subSound.numFiles = 1;
+
+    auto result = FSBank_Build(&subSound, 1, format, FSBANK_BUILD_DEFAULT, quality, nullptr, exportedPath.string().c_str());
+
+    // Failures and warnings come with a reason in the progress queue.
+    const FSBANK_PROGRESSITEM* item = nullptr;
+    while (FSBank_FetchNextProgressItem(&item) == FSBANK_OK && item)
+    {
+        if (item->state == FSBANK_STATE_FAILED)
+            blError("{}: {}", resource.relativePath, static_cast<const FSBANK_STATEDATA_FAILED*>(item->stateData)->errorString);
+        else if (item->state == FSBANK_STATE_WARNING)
+            blWarning("{}: {}", resource.relativePath, static_cast<const FSBANK_STATEDATA_WARNING*>(item->stateData)->warningString);
+
+        FSBank_ReleaseProgressItem(item);
+    }
+
+    if (result != FSBANK_OK)
+    {
+        blError("{}: Could not build the sound bank, {}", resource.relativePath, FSBank_ErrorString(result));
+        return false;
+    }
+
+    return true;
+}
+
+#endif
+
+std::string GetAudioBackend()
+{
+#ifdef BLUEMETAL_FSBANK
+    return fmt::format("FSBank {:08x}", FMOD_VERSION);
+#else
+    return "Passthrough";
+#endif
+}
+
+bool ProcessAudio(ProcessorState& state, ResourceFile& resource)
+{
+#ifdef BLUEMETAL_FSBANK
+    auto exportedPath = (state.outputPath / resource.relativePath).replace_extension(".fsb");
+    auto exportedFilename = exportedPath.filename();
+    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path() / exportedFilename;
+
+    std::filesystem::create_directories(exportedPath.parent_path());
+
+    // Decompressed sounds end up as PCM either way, Vorbis only keeps them small on disk.
+    static const std::map<std::string, FSBANK_FORMAT> codecs = {
+        {"Vorbis", FSBANK_FORMAT_VORBIS},
+        {"FADPCM", FSBANK_FORMAT_FADPCM},
+        {"PCM", FSBANK_FORMAT_PCM},
+    };
+
+    auto loadMode = resource.properties.value("loadMode", "Decompress");
+    auto codecName = resource.properties.value("codec", loadMode == "Compressed" ? "FADPCM" : "Vorbis");
+
+    auto codec = codecs.find(codecName);
+    if (codec == codecs.end())
+    {
+        blError("{}: Unknown codec {}, expected Vorbis, FADPCM or PCM.", resource.relativePath, codecName);
+        return false;
+    }
+
+    // "quality" from 1 to 100 for Vorbis, zero leaves it to FSBank.
+    auto quality = resource.properties.value("quality", 0u);
+
+    if (!BuildBank(state, resource, codec->second, quality, exportedPath))
+        return false;
+
+    blVerbose("{}: Baked as {}, loads as {}.", resource.relativePath, codecName, loadMode);
+
+    resource.bakedPath = relativeExportedPath;
+    return true;
+#else
+    // The engine using FMOD supports a lot of audio codecs and filetypes, the source is used as is.
+    resource.bakedPath.clear();
+    return true;
+#endif
+}
@@ -0,0 +1,373 @@
+#include <random>
+
+#include "Core/Platform.h"
+
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+#include "Core/Hash.h"
+#include "Core/Print.h"
+#include "BakeCache.h"
+
+static std::string ToHex(uint64_t value)
+{
+    return fmt::format("{:016x}", value);
+}
+
+static uint64_t FromHex(const std::string& hex)
+{
+    return std::stoull(hex, nullptr, 16);
+}
+
+// Unique between the threads of every bake process sharing a store, thread ids repeat across processes.
+static std::string GetTemporarySuffix()
+{
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    auto pid = _getpid();
+#else
+    auto pid = getpid();
+#endif
+
+    thread_local std::mt19937_64 random{((uint64_t)std::random_device{}() << 32) ^ std::random_device{}()};
+    return fmt::format("{}.{:016x}", pid, random());
+}
+
+BakeCache::BakeCache(const std::filesystem::path& bakedPath, const std::filesystem::path& storePath, bool rebuild)
+    : _bakedPath(bakedPath)
+    , _storePath(storePath)
+    , _rebuild(rebuild)
+{
+}
+
+void BakeCache::Load()
+{
+    auto path = _bakedPath / "BakeCache.json";
+    if (!std::filesystem::exists(path))
+        return;
+
+    try
+    {
+        std::ifstream file(path);
+        auto root = nlohmann::json::parse(file);
+
+        if (root["version"].get<uint32_t>() != Version)
+        {
+            blInfo("Bake cache is from an older version, rebaking everything.");
+            return;
+        }
+
+        for (const auto& [name, object] : root["resources"].items())
+        {
+            Entry entry;
+            entry.type = object["type"].get<std::string>();
+            entry.processorVersion = object["processorVersion"].get<uint32_t>();
+            entry.backend = object["backend"].get<std::string>();
+            entry.options = object["options"].get<std::string>();
+            entry.key = FromHex(object["key"].get<std::string>());
+            entry.bakedPath = object["bakedPath"].get<std::string>();
+            entry.references = object.value("references", std::vector<std::string>{});
+
+            for (const auto& fileObject : object["files"])
+            {
+                FileStamp stamp;
+                stamp.path = fileObject["path"].get<std::string>();
+                stamp.size = fileObject["size"].get<uint64_t>();
+                stamp.time = fileObject["time"].get<int64_t>();
+                stamp.hash = FromHex(fileObject["hash"].get<std::string>());
+                entry.files.push_back(stamp);
+            }
+
+            _entries[name] = std::move(entry);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        blWarning("Could not read the bake cache, rebaking everything: {}", e.what());
+        _entries.clear();
+    }
+}
+
+void BakeCache::Save()
+{
+    std::lock_guard lock(_mutex);
+
+    nlohmann::json root;
+    root["version"] = Version;
+    root["resources"] = nlohmann::json::object();
+
+    for (const auto& [name, entry] : _entries)
+    {
+        nlohmann::json object;
+        object["type"] = entry.type;
+        object["processorVersion"] = entry.processorVersion;
+        object["backend"] = entry.backend;
+        object["options"] = entry.options;
+        object["key"] = ToHex(entry.key);
+        object["bakedPath"] = entry.bakedPath;
+        object["references"] = entry.references;
+        object["files"] = nlohmann::json::array();
+
+        for (const auto& stamp : entry.files)
+        {
+            object["files"].push_back({
+                {"path", stamp.path},
+                {"size", stamp.size},
+                {"time", stamp.time},
+                {"hash", ToHex(stamp.hash)}});
+        }
+
+        root["resources"][name] = std::move(object);
+    }
+
+    // Write then swap so an interrupted bake never leaves a half written database.
+    auto path = _bakedPath / "BakeCache.json";
+    auto temporaryPath = _bakedPath / "BakeCache.json.tmp";
+
+    std::filesystem::create_directories(_bakedPath);
+    std::ofstream file(temporaryPath, std::ios::out | std::ios::trunc);
+    file << root.dump(4);
+    file.close();
+
+    std::filesystem::rename(temporaryPath, path);
+}
+
+bool BakeCache::Restore(ProcessorState& state, ResourceFile& resource)
+{
+    if (_rebuild)
+        return false;
+
+    auto current = BuildEntry(state, resource);
+
+    std::optional<Entry> previous;
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _entries.find(resource.relativePath);
+        if (it != _entries.end())
+            previous = it->second;
+    }
+
+    // Fast path, nothing was touched since the last bake.
+    if (previous && StampsMatch(*previous, current) && OutputExists(*previous))
+    {
+        resource.bakedPath = previous->bakedPath;
+        resource.references = previous->references;
+        return true;
+    }
+
+    // Something was touched, the content decides if it really changed.
+    HashEntry(state, current);
+
+    if (previous && previous->key == current.key && OutputExists(*previous))
+    {
+        blVerbose("{}: Touched but unchanged.", resource.relativePath);
+        current.bakedPath = previous->bakedPath;
+        current.references = previous->references;
+        resource.bakedPath = current.bakedPath;
+        resource.references = current.references;
+
+        std::lock_guard lock(_mutex);
+        _entries[resource.relativePath] = std::move(current);
+        return true;
+    }
+
+    if (RestoreFromStore(current))
+    {
+        blVerbose("{}: Restored from the shared store.", resource.relativePath);
+        resource.bakedPath = current.bakedPath;
+        resource.references = current.references;
+
+        std::lock_guard lock(_mutex);
+        _entries[resource.relativePath] = std::move(current);
+        return true;
+    }
+
+    std::lock_guard lock(_mutex);
+    _hashed[resource.relativePath] = std::move(current);
+    return false;
+}
+
+void BakeCache::Store(ProcessorState& state, const ResourceFile& resource)
+{
+    Entry entry;
+
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _hashed.find(resource.relativePath);
+        if (it != _hashed.end())
+        {
+            entry = std::move(it->second);
+            _hashed.erase(it);
+        }
+    }
+
+    // Rebuilds skip hashing in Restore, so it's done here instead.
+    if (entry.type.empty())
+    {
+        entry = BuildEntry(state, resource);
+        HashEntry(state, entry);
+    }
+
+    entry.bakedPath = resource.bakedPath.generic_string();
+    entry.references = resource.references;
+    CopyToStore(entry);
+
+    std::lock_guard lock(_mutex);
+    _entries[resource.relativePath] = std::move(entry);
+}
+
+BakeCache::Entry BakeCache::BuildEntry(ProcessorState& state, const ResourceFile& resource) const
+{
+    auto manifestRoot = state.manifestPath.parent_path();
+
+    Entry entry;
+    entry.type = resource.type;
+    entry.processorVersion = GetProcessorVersion(resource.type);
+    entry.backend = GetProcessorBackend(state, resource.type);
+    entry.options = resource.properties.dump();
+
+    auto stamp = [&](const std::filesystem::path& path){
+        FileStamp fileStamp;
+        fileStamp.path = std::filesystem::relative(path, manifestRoot).generic_string();
+        fileStamp.size = std::filesystem::file_size(path);
+        fileStamp.time = std::filesystem::last_write_time(path).time_since_epoch().count();
+        return fileStamp;
+    };
+
+    entry.files.push_back(stamp(resource.absolutePath));
+    for (const auto& dependency : resource.dependencies)
+        entry.files.push_back(stamp(dependency));
+
+    return entry;
+}
+
+bool BakeCache::StampsMatch(const Entry& a, const Entry& b)
+{
+    if (a.type != b.type || a.processorVersion != b.processorVersion || a.backend != b.backend || a.options != b.options)
+        return false;
+
+    if (a.files.size() != b.files.size())
+        return false;
+
+    for (size_t i = 0; i < a.files.size(); i++)
+    {
+        if (a.files[i].path != b.files[i].path || a.files[i].size != b.files[i].size || a.files[i].time != b.files[i].time)
+            return false;
+    }
+
+    return true;
+}
+
+void BakeCache::HashEntry(ProcessorState& state, Entry& entry)
+{
+    auto manifestRoot = state.manifestPath.parent_path();
+
+    // The key covers everything that could change the output, including the resource
+    // path as that decides where the output ends up.
+    uint64_t key = bl::Hash64(entry.type);
+    key = bl::Hash64(fmt::format("{}", entry.processorVersion), key);
+    key = bl::Hash64(entry.backend, key);
+    key = bl::Hash64(entry.options, key);
+
+    for (auto& stamp : entry.files)
+    {
+        stamp.hash = HashFile(manifestRoot / stamp.path);
+        key = bl::Hash64(stamp.path, key);
+        key = bl::Hash64(ToHex(stamp.hash), key);
+    }
+
+    entry.key = key;
+}
+
+uint64_t BakeCache::HashFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<std::byte> buffer(64 * 1024);
+
+    uint64_t hash = BL_HASH64_FNV_BASIS;
+    while (file)
+    {
+        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        hash = bl::Hash64(std::span{buffer.data(), (size_t)file.gcount()}, hash);
+    }
+
+    return hash;
+}
+
+bool BakeCache::OutputExists(const Entry& entry) const
+{
+    return entry.bakedPath.empty() || std::filesystem::exists(_bakedPath / entry.bakedPath);
+}
+
+bool BakeCache::RestoreFromStore(Entry& entry) const
+{
+    if (_storePath.empty())
+        return false;
+
+    auto directory = _storePath / ToHex(entry.key);
+    if (!std::filesystem::exists(directory / "Bake.json"))
+        return false;
+
+    try
+    {
+        std::ifstream file(directory / "Bake.json");
+        auto bake = nlohmann::json::parse(file);
+        entry.bakedPath = bake["bakedPath"].get<std::string>();
+        entry.references = bake.value("references", std::vector<std::string>{});
+
+        if (!entry.bakedPath.empty())
+        {
+            std::filesystem::create_directories((_bakedPath / entry.bakedPath).parent_path());
+            std::filesystem::copy_file(directory / entry.bakedPath, _bakedPath / entry.bakedPath, std::filesystem::copy_options::overwrite_existing);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        blWarning("Could not restore {} from the shared store: {}", ToHex(entry.key), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void BakeCache::CopyToStore(const Entry& entry) const
+{
+    if (_storePath.empty())
+        return;
+
+    auto directory = _storePath / ToHex(entry.key);
+    if (std::filesystem::exists(directory))
+        return;
+
+    // Other checkouts may be storing the same key right now, fill a private directory
+    // first then move it into place in one step.
+    auto temporary = _storePath / fmt::format("{}.{}.tmp", ToHex(entry.key), GetTemporarySuffix());
+
+    try
+    {
+        std::filesystem::create_directories(temporary);
+
+        if (!entry.bakedPath.empty())
+        {
+            std::filesystem::create_directories((temporary / entry.bakedPath).parent_path());
+            std::filesystem::copy_file(_bakedPath / entry.bakedPath, temporary / entry.bakedPath, std::filesystem::copy_options::overwrite_existing);
+        }
+
+        std::ofstream file(temporary / "Bake.json");
+        file << nlohmann::json{{"bakedPath", entry.bakedPath}, {"references", entry.references}}.dump(4);
+        file.close();
+
+        std::filesystem::rename(temporary, directory);
+    }
+    catch (const std::exception& e)
+    {
+        // Losing the race to another writer is fine, the stored output is identical.
+        std::error_code ignored;
+        std::filesystem::remove_all(temporary, ignored);
+
+        if (!std::filesystem::exists(directory))
+            blWarning("Could not copy {} into the shared store: {}", entry.bakedPath, e.what());
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mutex>
+
+#include "AssetProcessor.h"
+
+// The bake cache remembers what every resource was baked from so unchanged resources
+// can be skipped on the next run.
+//
+// A resource is up to date when its processor version and backend, bake options and
+// the content of its source file and dependencies all match what was recorded. Size and
+// modified time are checked first, files are only hashed when those change.
+//
+// Every bake is also keyed by the hash of everything that went into it. When a shared
+// store directory is given, outputs are copied there under that key so any checkout
+// or branch baking identical inputs can copy them back out instead of rebaking.
+//
+// Database (BakeCache.json next to the baked resources)
+//  version     (number)
+//  resources   (object keyed by resource path)
+//    type, processorVersion, backend, options, key, bakedPath
+//    references (array, resources the bake found the engine needs first, see ResourceFile)
+//    files     (array, the source file first then its dependencies)
+//      path, size, time, hash
+//
+// Shared Store
+//  <key>/Bake.json   bakedPath and references of the stored outputs
+//  <key>/<bakedPath> the baked outputs themselves
+class BakeCache
+{
+public:
+    BakeCache(const std::filesystem::path& bakedPath, const std::filesystem::path& storePath, bool rebuild);
+
+    void Load(); /** @brief Reads the bake database, a missing or old database just means everything rebakes. */
+    void Save(); /** @brief Writes the bake database back next to the baked resources. */
+
+    bool Restore(ProcessorState& state, ResourceFile& resource); /** @brief Returns true if the resource is up to date or could be copied from the shared store. Thread safe. */
+    void Store(ProcessorState& state, const ResourceFile& resource); /** @brief Records a successful bake and copies its output into the shared store. Thread safe. */
+
+private:
+    static constexpr uint32_t Version = 2;
+
+    struct FileStamp
+    {
+        std::string path; // Relative to the manifest root.
+        uint64_t size = 0;
+        int64_t time = 0;
+        uint64_t hash = 0;
+    };
+
+    struct Entry
+    {
+        std::string type;
+        uint32_t processorVersion = 0;
+        std::string backend; // See GetProcessorBackend.
+        std::string options;
+        uint64_t key = 0;
+        std::string bakedPath;
+        std::vector<std::string> references;
+        std::vector<FileStamp> files;
+    };
+
+    Entry BuildEntry(ProcessorState& state, const ResourceFile& resource) const; /** @brief Stamps every input without hashing. */
+    static bool StampsMatch(const Entry& a, const Entry& b);
+    static void HashEntry(ProcessorState& state, Entry& entry);
+    static uint64_t HashFile(const std::filesystem::path& path);
+    bool OutputExists(const Entry& entry) const;
+    bool RestoreFromStore(Entry& entry) const; /** @brief Fills in the bakedPath and references of the stored outputs. */
+    void CopyToStore(const Entry& entry) const;
+
+    std::filesystem::path _bakedPath;
+    std::filesystem::path _storePath;
+    bool _rebuild;
+    std::mutex _mutex;
+    std::map<std::string, Entry> _entries;
+    std::map<std::string, Entry> _hashed; /** @brief Entries that were hashed during Restore, saves hashing again in Store. */
+};
@@ -0,0 +1,115 @@
+#include <fstream>
+
+#include "Core/Print.h"
+#include "BakeReport.h"
+#include "PackWriter.h"
+
+static thread_local BakeReportEntry* currentEntry = nullptr;
+
+static const char* stageNames[] = {"cache", "read", "import", "optimize", "encode", "write"};
+static_assert(std::size(stageNames) == (size_t)BakeStage::eCount);
+
+void BeginBakeReport(BakeReportEntry* entry)
+{
+    currentEntry = entry;
+}
+
+void EndBakeReport()
+{
+    currentEntry = nullptr;
+}
+
+void MarkBakeCached()
+{
+    if (currentEntry)
+        currentEntry->cached = true;
+}
+
+void FinishBakeReport(const ProcessorState& state, const ResourceFile& resource, BakeReportEntry& entry)
+{
+    entry.path = resource.relativePath;
+    entry.type = resource.type;
+
+    // Files that can't be sized count as empty rather than failing the bake.
+    auto size = [](const std::filesystem::path& path) -> uint64_t {
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        return error ? 0 : size;
+    };
+
+    entry.bytesIn = size(resource.absolutePath);
+    for (const auto& dependency : resource.dependencies)
+        entry.bytesIn += size(dependency);
+
+    if (entry.status)
+        entry.bytesOut = size(GetManifestFile(state, resource));
+}
+
+static nlohmann::json ToJson(const BakeReportEntry& entry)
+{
+    nlohmann::json seconds;
+    seconds["total"] = entry.seconds;
+    for (size_t i = 0; i < (size_t)BakeStage::eCount; i++)
+        seconds[stageNames[i]] = entry.stageSeconds[i];
+
+    nlohmann::json object;
+    object["seconds"] = seconds;
+    object["bytesIn"] = entry.bytesIn;
+    object["bytesOut"] = entry.bytesOut;
+    object["ratio"] = entry.bytesOut > 0 ? (double)entry.bytesIn / (double)entry.bytesOut : 0.0;
+    return object;
+}
+
+bool WriteBakeReport(const std::filesystem::path& path, const std::vector<BakeReportEntry>& entries, uint32_t jobs, double seconds)
+{
+    nlohmann::json root;
+    root["version"] = 1;
+    root["jobs"] = jobs;
+    root["seconds"] = seconds;
+    root["resources"] = nlohmann::json::array();
+
+    BakeReportEntry total;
+    for (const auto& entry : entries)
+    {
+        auto object = ToJson(entry);
+        object["path"] = entry.path;
+        object["type"] = entry.type;
+        object["status"] = entry.status;
+        object["cached"] = entry.cached;
+        root["resources"].push_back(std::move(object));
+
+        total.seconds += entry.seconds;
+        for (size_t i = 0; i < (size_t)BakeStage::eCount; i++)
+            total.stageSeconds[i] += entry.stageSeconds[i];
+
+        total.bytesIn += entry.bytesIn;
+        total.bytesOut += entry.bytesOut;
+    }
+
+    root["total"] = ToJson(total);
+
+    if (!path.parent_path().empty())
+        std::filesystem::create_directories(path.parent_path());
+
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+    {
+        blError("Could not open the bake report for writing.");
+        return false;
+    }
+
+    out << root.dump(4);
+    return true;
+}
+
+BakeStageTimer::BakeStageTimer(BakeStage stage)
+    : _stage(stage)
+    , _start(std::chrono::steady_clock::now())
+{
+}
+
+BakeStageTimer::~BakeStageTimer()
+{
+    if (currentEntry)
+        currentEntry->stageSeconds[(size_t)_stage] += std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+}
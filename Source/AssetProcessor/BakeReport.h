@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+
+#include "AssetProcessor.h"
+
+// The bake report says where bake time went, written as JSON with --report so runs can be
+// compared by scripts.
+//
+// Processors time their stages with a BakeStageTimer, it adds to the report entry of the
+// resource baking on the calling thread. A stage a processor doesn't have stays at zero,
+// model imports read their files through assimp so models only have an import stage.
+//
+// Report
+//  version       (number)
+//  jobs          (number) resources baked at once
+//  seconds       (number) wall time of the whole run
+//  total         (object) the resource fields below summed over every resource
+//  resources     (array, manifest order)
+//    path, type, status (bool), cached (bool, skipped or restored by the bake cache)
+//    seconds     (object) total, cache, read, import, optimize, encode, write
+//    bytesIn     (number) source file and dependencies
+//    bytesOut    (number) what the engine loads, the source again when nothing was baked
+//    ratio       (number) bytesIn / bytesOut
+
+enum class BakeStage
+{
+    eCache, // Stamping and hashing inputs for the bake cache.
+    eRead,
+    eImport,
+    eOptimize,
+    eEncode,
+    eWrite,
+    eCount,
+};
+
+struct BakeReportEntry
+{
+    std::string path;
+    std::string type;
+    bool status = false;
+    bool cached = false;
+    double seconds = 0.0;
+    std::array<double, (size_t)BakeStage::eCount> stageSeconds = {};
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+};
+
+// Sends the calling thread's stage timings to an entry until EndBakeReport, like log capture.
+void BeginBakeReport(BakeReportEntry* entry);
+void EndBakeReport();
+
+// Flags the calling thread's resource as skipped or restored by the bake cache.
+void MarkBakeCached();
+
+// Fills in the sizes once the resource is done.
+void FinishBakeReport(const ProcessorState& state, const ResourceFile& resource, BakeReportEntry& entry);
+
+bool WriteBakeReport(const std::filesystem::path& path, const std::vector<BakeReportEntry>& entries, uint32_t jobs, double seconds);
+
+class BakeStageTimer
+{
+public:
+    BakeStageTimer(BakeStage stage);
+    ~BakeStageTimer();
+
+private:
+    BakeStage _stage;
+    std::chrono::steady_clock::time_point _start;
+};
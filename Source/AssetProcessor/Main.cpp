@@ -6,63 +6,56 @@
 //
 // Here's a basic table of how assets are converted.
 //
-// Texture -> QOI (Quite Ok Image)
-// Static Model -> A custom binary of packed vertices and images directly after
-// Sound -> FLAC
-// Shader (GLSL) -> SPIR-V using glslc
+// Texture -> BMTF, the full mip chain ready for one GPU copy, see Graphics/TextureFileFormat.h
+// Static Model -> BMMF, a sectioned binary the engine maps and uploads, see Graphics/ModelFormat.h
+// Sound -> FSB, one sound coded for the way the engine loads it, see AudioProcessor.cpp
+// Shader (GLSL) -> SPIR-V using shaderc, or glslc when shaderc wasn't found
+//
+// Resources that haven't changed since the last bake are skipped, see BakeCache.h.
+// Everything processed is then packed into one resource pack the engine memory maps,
+// see Resource/PackFormat.h, and listed in the engine manifest. With --compress the
+// pack's payloads are stored in chunks the engine decompresses in parallel.
+//
+// Where the time went can be written out with --report, see BakeReport.h. To measure bake
+// throughput without project assets, --generate-stress-corpus writes a synthetic one.
+// With --watch the processor stays running and rebakes whatever changes, see Watcher.h.
 
 
 #include <fstream>
+#include <future>
 
 #include <argparse/argparse.hpp>
 
 #include <nlohmann/json.hpp>
 
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
-#include <assimp/scene.h>
-
-#include "qoixx.hpp"
-
 #include "Core/Print.h"
-#include "Core/FileByte.h"
-#include "Graphics/stb_image.h"
-#include "Graphics/Vertex.h"
-
-struct ResourceFile
+#include "Core/ThreadPool.h"
+#include "AssetProcessor.h"
+#include "BakeCache.h"
+#include "BakeReport.h"
+#include "PackWriter.h"
+#include "ShaderCompiler.h"
+#include "StressCorpus.h"
+#include "Watcher.h"
+
+struct ProcessResult
 {
-    std::string type;
-    std::string relativePath;
-    std::filesystem::path absolutePath;
-    std::filesystem::path bakedPath; // Empty if no baking took place.
-    nlohmann::json properties;
+    bool status = false;
+    std::string log; // Everything the processor printed, replayed in manifest order.
+    BakeReportEntry report;
 };
 
-struct ProcessorState
-{
-    std::vector<ResourceFile> resources;
-    std::unordered_set<std::string> resourceChecker;
-    std::filesystem::path manifestPath;
-    std::filesystem::path outputPath;
-    std::filesystem::path materialOutputPath;
-};
-
-bool ProcessShader(ProcessorState& state, ResourceFile& resource);
-bool ProcessTexture(ProcessorState& state, ResourceFile& resource);
-bool ProcessAudio(ProcessorState& state, ResourceFile& resource);
-bool ProcessModel(ProcessorState& state, ResourceFile& resource);
+ProcessResult ProcessResourceCaptured(ProcessorState& state, ResourceFile& resource);
 
 int main(int argc, const char** argv)
 {
     argparse::ArgumentParser parser{"AssetProcessor", "0.1"};
     parser
         .add_argument("-m", "--manifest")
-        .help("The resource manifest containing all project resources.")
-        .required();
+        .help("The resource manifest containing all project resources, required unless generating a stress corpus.");
     parser
         .add_argument("-o", "--bakedPath")
-        .help("The path where all baked resources end up when processed.")
-        .required();
+        .help("The path where all baked resources end up when processed, required unless generating a stress corpus.");
     parser
         .add_argument("-mo", "--materialOutputPath")
         .help("Exported model materials can be exported to a separate material folder.")
@@ -73,23 +66,74 @@ int main(int argc, const char** argv)
     parser
         .add_argument("-v", "--verbose")
         .help("Turns on verbose logging mode.")
-        .default_value(false);
+        .default_value(false)
+        .implicit_value(true);
+    parser
+        .add_argument("-j", "--jobs")
+        .help("Number of resources baked at once, defaults to the number of hardware threads.")
+        .default_value((int)std::max(std::thread::hardware_concurrency(), 1u))
+        .scan<'i', int>();
+    parser
+        .add_argument("-c", "--cachePath")
+        .help("A shared directory baked outputs are stored in by content, other checkouts baking the same inputs reuse them.")
+        .default_value("");
+    parser
+        .add_argument("-r", "--rebuild")
+        .help("Ignores the bake cache and rebakes every resource.")
+        .default_value(false)
+        .implicit_value(true);
+    parser
+        .add_argument("-p", "--pack")
+        .help("Name of the resource pack written into the baked path, empty to only write loose files.")
+        .default_value("Resources.bpak");
+    parser
+        .add_argument("--compress")
+        .help("Codec the pack's payloads are compressed with in independent chunks, zlib, or empty to store them as is.")
+        .default_value("");
+    parser
+        .add_argument("--report")
+        .help("Writes per resource, per stage bake times and sizes to this JSON file, see BakeReport.h.")
+        .default_value("");
+    parser
+        .add_argument("-w", "--watch")
+        .help("Keeps running after the bake, rebaking resources as their files change and telling a running game to reload them.")
+        .default_value(false)
+        .implicit_value(true);
+    parser
+        .add_argument("--generate-stress-corpus")
+        .help("Writes a synthetic corpus of large textures and meshes with its own manifest into this directory, then exits.")
+        .default_value("");
+    parser
+        .add_argument("--stress-count")
+        .help("Number of textures and of meshes in the stress corpus.")
+        .default_value(8)
+        .scan<'i', int>();
 
     try
     {
         parser.parse_args(argc, argv);
     }
-    catch (std::exception e)
+    catch (const std::exception& e)
     {
         blError("{}, {}", e.what(), parser);
         std::exit(EXIT_FAILURE);
     }
 
+    auto stressCorpusPath = parser.get<std::string>("generate-stress-corpus");
+    if (!stressCorpusPath.empty())
+        return GenerateStressCorpus(stressCorpusPath, (uint32_t)std::max(parser.get<int>("stress-count"), 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (!parser.present("manifest") || !parser.present("bakedPath"))
+    {
+        blError("The manifest and baked path are both required, {}", parser);
+        std::exit(EXIT_FAILURE);
+    }
+
     ProcessorState state;
 
     // Process the manifest file.
     state.manifestPath = parser.get<std::string>("manifest");
-    state.outputPath = parser.get<std::string>("outputPath");
+    state.outputPath = parser.get<std::string>("bakedPath");
     state.materialOutputPath = parser.get<std::string>("materialOutputPath");
 
     if (parser.get<bool>("verbose"))
@@ -98,6 +142,21 @@ int main(int argc, const char** argv)
         blVerbose("Enabling verbose logging.");
     }
 
+    // Checked before baking, a misspelled codec shouldn't cost a whole bake.
+    const bl::Codec* codec = nullptr;
+    if (auto codecName = parser.get<std::string>("compress"); !codecName.empty())
+    {
+        try
+        {
+            codec = &bl::GetCodec(codecName);
+        }
+        catch (const std::exception& e)
+        {
+            blError("{}", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+
     std::filesystem::path manifestRoot = state.manifestPath.parent_path();
 
     try
@@ -113,6 +172,7 @@ int main(int argc, const char** argv)
             resource.relativePath = object["path"].get<std::string>();
             resource.absolutePath = manifestRoot / resource.relativePath;
             resource.bakedPath.clear();
+            resource.properties = object;
 
             // Ensure that the path doesn't exist yet.
             if (state.resourceChecker.find(resource.relativePath) != state.resourceChecker.end())
@@ -124,6 +184,17 @@ int main(int argc, const char** argv)
             state.resources.push_back(resource);
             state.resourceChecker.emplace(resource.relativePath);
         }
+
+        for (const auto& [name, paths] : manifestJson.value("groups", nlohmann::json::object()).items())
+        {
+            for (const auto& path : paths)
+            {
+                if (!state.resourceChecker.contains(path.get<std::string>()))
+                    blWarning("Group {}: {} isn't in the manifest, leaving it out.", name, path.get<std::string>());
+                else
+                    state.groups[name].push_back(path.get<std::string>());
+            }
+        }
     } 
     catch(...)
     {
@@ -131,280 +202,281 @@ int main(int argc, const char** argv)
         exit(EXIT_FAILURE);
     }
 
+    // Anything that touches shared state happens here, before the resources are
+    // handed out to workers. Output directories are made up front so workers never
+    // race each other creating the same folder.
+    std::vector<ResourceFile*> pending;
+    pending.reserve(state.resources.size());
+
     for (auto& resource : state.resources)
     {
         // Ensure that the resource actually exists.
         if (!std::filesystem::exists(resource.absolutePath) ||
             !std::filesystem::is_regular_file(resource.absolutePath))
         {
-            blError("Resource does not exist or is not a file: {}", resource.absolutePath);
+            blError("Resource does not exist or is not a file: {}", resource.absolutePath.string());
             continue;
         }
 
-        blVerbose("Beginning processing of: {}", resource.relativePath);
-        bool status = false;
+        std::filesystem::create_directories((state.outputPath / resource.relativePath).parent_path());
+        pending.push_back(&resource);
+    }
+
+    BakeCache cache{state.outputPath, parser.get<std::string>("cachePath"), parser.get<bool>("rebuild")};
+    cache.Load();
+    state.cache = &cache;
+
+    ShaderCompiler shaderCompiler;
+    state.shaderCompiler = &shaderCompiler;
+
+    if (!shaderCompiler.IsInProcess())
+        blVerbose("shaderc was not found, shaders will be compiled with glslc.");
+
+    auto start = std::chrono::steady_clock::now();
+    int jobs = std::max(parser.get<int>("jobs"), 1);
+    blVerbose("Baking {} resources using {} jobs.", pending.size(), jobs);
 
-        if (resource.type == "Shader")
+    // Results are always reported in manifest order, however they were baked.
+    std::vector<std::future<ProcessResult>> results;
+    results.reserve(pending.size());
+
+    std::unique_ptr<bl::ThreadPool> pool;
+    if (jobs > 1)
+        pool = std::make_unique<bl::ThreadPool>((uint32_t)jobs);
+
+    for (auto* resource : pending)
+    {
+        if (pool)
         {
-            status = ProcessShader(state, resource);
+            results.push_back(pool->Submit([&state, resource](){ return ProcessResourceCaptured(state, *resource); }));
         }
-        else if (resource.type == "Texture")
-        {
-            status = ProcessTexture(state, resource);
-        } 
-        else if (resource.type == "Audio")
+        else
         {
-            status = ProcessAudio(state, resource);
+            std::promise<ProcessResult> promise;
+            promise.set_value(ProcessResourceCaptured(state, *resource));
+            results.push_back(promise.get_future());
         }
-        else if (resource.type == "Model")
+    }
+
+    size_t numFailed = 0;
+    std::vector<const ResourceFile*> processed;
+    processed.reserve(pending.size());
+
+    std::vector<BakeReportEntry> report;
+    report.reserve(pending.size());
+
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        auto result = results[i].get();
+        fmt::print("{}", result.log);
+        report.push_back(std::move(result.report));
+
+        if (result.status)
         {
-            status = ProcessModel(state, resource);
+            blInfo("{}: Processed successfully.", pending[i]->relativePath);
+            processed.push_back(pending[i]);
         }
-
-        if (status)
-            blInfo("{}: Processed successfully.", resource.relativePath);
         else
-            blError("{}: Could not be processed.", resource.relativePath);
+        {
+            blError("{}: Could not be processed.", pending[i]->relativePath);
+            numFailed++;
+        }
     }
 
-    return EXIT_SUCCESS;
-}
+    if (numFailed > 0)
+        blWarning("{} of {} resources could not be processed.", numFailed, pending.size());
 
-bool ProcessShader(ProcessorState& state, ResourceFile& resource)
-{
-    // Build the final absolutePath, with proper 'spv' extension.
-    auto exportedPath = state.outputPath / resource.relativePath;
-    std::filesystem::create_directories(exportedPath.parent_path());
+    cache.Save();
 
-    exportedPath.replace_extension(exportedPath.extension().string() + ".spv");
-    auto exportedFilename = exportedPath.filename();
-    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path();
-    relativeExportedPath.concat("/" + exportedFilename.string());
+    // The engine reads everything through one pack, the loose files stay for the bake cache.
+    std::vector<std::string> packs;
+    auto packName = parser.get<std::string>("pack");
 
-    // Run the glslc shader compilation command.
-    std::string cmd = fmt::format("glslc {} -o {}", resource.absolutePath.string(), exportedPath.string());
-    if (std::system(cmd.c_str()) != EXIT_SUCCESS)
+    if (!packName.empty())
     {
-        blError("{}: Could not compile shader resource.", resource.relativePath);
-        blWarning("This asset will not be added to the engine manifest.");
-        blWarning("Please ensure that you have the Vulkan SDK Installed.");
-        return false;
+        if (!WritePack(state, processed, state.outputPath / packName, codec))
+        {
+            blError("Could not write the resource pack!");
+            return EXIT_FAILURE;
+        }
+
+        packs.push_back(packName);
     }
 
-    // Export the final resource into the engine manifest.
-    resource.bakedPath = relativeExportedPath;
-    return true;
+    if (!WriteEngineManifest(state, processed, packs))
+        return EXIT_FAILURE;
+
+    auto reportPath = parser.get<std::string>("report");
+    if (!reportPath.empty())
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!WriteBakeReport(reportPath, report, (uint32_t)jobs, seconds))
+            return EXIT_FAILURE;
+    }
+
+    if (parser.get<bool>("watch"))
+        return WatchResources(state, pending) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
 }
 
-bool ProcessTexture(ProcessorState& state, ResourceFile& resource)
+ProcessResult ProcessResourceCaptured(ProcessorState& state, ResourceFile& resource)
 {
-    // Build the final absolutePath, with proper qoi extension.
-    auto exportedPath = (state.outputPath / resource.relativePath).replace_extension(".qoi");
-    auto exportedFilename = exportedPath.filename();
-    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path() / exportedFilename;
+    ProcessResult result;
 
-    std::filesystem::create_directories(exportedPath.parent_path());
+    bl::logging::beginCapture(&result.log);
+    BeginBakeReport(&result.report);
+    auto start = std::chrono::steady_clock::now();
 
-    if (resource.absolutePath.extension() == ".qoi")
-    {
-        blInfo("{}: Already in QOI format, not baking.", relativeExportedPath.string());
-        resource.bakedPath.clear();
-        return true;
-    }
-    
-    if (resource.absolutePath.extension() != ".png" &&
-        resource.absolutePath.extension() != ".jpg" &&
-        resource.absolutePath.extension() != ".jpeg")
+    try
     {
-        blError("{}: Invalid texture file type, please convert it manually.", resource.relativePath);
-        return false;
+        result.status = ProcessResource(state, resource);
     }
-
-    int x = 0, y = 0, channels = 0;
-    auto data = stbi_load(resource.absolutePath.string().c_str(), &x, &y, &channels, 4);
-
-    if (data == nullptr)
+    catch (const std::exception& e)
     {
-        blError("{}: Could not load this texture.", resource.absolutePath.string());
-        return false;
+        blError("{}: {}", resource.relativePath, e.what());
+        result.status = false;
     }
 
-    qoixx::qoi::desc desc;
-    desc.width = x;
-    desc.height = y;
-    desc.channels = 4;
-    desc.colorspace = qoixx::qoi::colorspace::linear; // We assume every texture is linear, it's easier to do math on!
-
-    auto out = qoixx::qoi::encode<std::vector<char>, stbi_uc>(data, x * y * 4, desc);
+    result.report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.report.status = result.status;
+    FinishBakeReport(state, resource, result.report);
 
-    std::ofstream outFile(exportedPath, std::ios::out | std::ios::binary);
-    outFile.write(out.data(), out.size());
-    outFile.close();
-
-    resource.bakedPath = relativeExportedPath;
-    return true;
+    EndBakeReport();
+    bl::logging::endCapture();
+    return result;
 }
 
-bool ProcessAudio(ProcessorState& state, ResourceFile& resource)
+uint32_t GetProcessorVersion(const std::string& type)
 {
-    // The engine using FMOD supports a lot of audio codecs and filetypes.
-    // We don't need to do any processing!
-    resource.bakedPath.clear();
-    return true;
+    if (type == "Shader") return 2;
+    if (type == "Texture") return 4;
+    if (type == "Audio") return 2;
+    if (type == "Model") return 9;
+    return 0;
 }
 
-// Models have a custom binary format that's just fast for the engine to load without much processing.
-// Any materials are going to be broken out of the 
-//
-// Model (header)
-//  magic       (uint32_t) 'B' 'M' 'M' 'F'
-//  modelVersion (uint32_t) (0)
-//  numStaticMeshes (uint32_t)
-//  numTextures     (uint32_t)
-//  numMaterials    (uint32_t)
-//
-// Static Meshes (array)
-//  numVertices (uint32_t)
-//  numIndices  (uint32_t)
-//  numTextures (uint32_t)
-//  Vertices    (sizeof(bl::Vertex) * numVertices)
-//  Indices     (sizeof(uint32_t) * numIndices)
-//  Transform   (sizeof(glm::mat4))
-//
-// Materials (header)
-//  numMaterialResourcePaths (uint32_t)
-//  numBytesInResourcePaths (uint64_t)
-//
-//    Resource Paths (array)
-//      materialResourcePath (nul-terminated string)
-//
+std::string GetProcessorBackend(const ProcessorState& state, const std::string& type)
+{
+    if (type == "Shader" && state.shaderCompiler) return state.shaderCompiler->GetBackend();
+    if (type == "Audio") return GetAudioBackend();
+    return "";
+}
 
+bool ProcessResource(ProcessorState& state, ResourceFile& resource)
+{
+    if (resource.type == "Shader")
+        resource.dependencies = CollectShaderIncludes(resource.absolutePath);
 
-void ProcessNodes(const aiNode* node, const aiScene* scene, std::ofstream& stream);
-void ProcessMesh(const aiMesh* mesh, std::ofstream& stream);
-void ProcessMaterials(const aiMesh* mesh, const aiScene* scene, std::ofstream& stream);
+    // Picked before the cache is checked, the engine manifest records it even when the bake is skipped.
+    if (resource.type == "Audio" && !ChooseSoundLoadMode(resource))
+        return false;
 
-void ProcessNodes(const aiNode* node, const aiScene* scene, std::ofstream& stream)
-{
+    bool restored = false;
+    {
+        BakeStageTimer timer{BakeStage::eCache};
+        restored = state.cache && state.cache->Restore(state, resource);
+    }
 
-    for (unsigned int j = 0; j < node->mNumMeshes; j++)
+    if (restored)
     {
-        ProcessMesh(scene->mMeshes[node->mMeshes[j]], stream);
+        blVerbose("{}: Up to date, skipping.", resource.relativePath);
+        MarkBakeCached();
+        return true;
+    }
 
-        auto& m = node->mTransformation;
-        float transformationMatrix[16] = {
-            (float)m.a1, (float)m.a2, (float)m.a3, (float)m.a4,
-            (float)m.b1, (float)m.b2, (float)m.b3, (float)m.b4,
-            (float)m.c1, (float)m.c2, (float)m.c3, (float)m.c4,
-            (float)m.d1, (float)m.d2, (float)m.d3, (float)m.d4
-        };
+    blVerbose("Beginning processing of: {}", resource.relativePath);
+    bool status = false;
 
-        stream.write(reinterpret_cast<char*>(transformationMatrix), sizeof(transformationMatrix));
+    if (resource.type == "Shader")
+    {
+        status = ProcessShader(state, resource);
     }
-
-    for (unsigned int i = 0; i < node->mNumChildren; i++)
+    else if (resource.type == "Texture")
+    {
+        status = ProcessTexture(state, resource);
+    } 
+    else if (resource.type == "Audio")
     {
-        ProcessNodes(node->mChildren[i], scene, stream);
+        status = ProcessAudio(state, resource);
     }
-}
-
-void ProcessMesh(const aiMesh* mesh, std::ofstream& stream)
-{
-    int numIndices = 0;
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    else if (resource.type == "Model")
     {
-        numIndices += mesh->mFaces[i].mNumIndices;
+        status = ProcessModel(state, resource);
     }
 
-    bl::WriteT<uint32_t>(stream, mesh->mNumVertices);
-    bl::WriteT<uint32_t>(stream, numIndices);
+    if (status && state.cache)
+    {
+        BakeStageTimer timer{BakeStage::eCache};
+        state.cache->Store(state, resource);
+    }
 
-    std::vector<bl::Vertex> vertices;
-    std::vector<uint32_t> indices;
+    return status;
+}
 
-    vertices.reserve(mesh->mNumVertices);
-    vertices.reserve(numIndices);
+std::vector<std::filesystem::path> CollectShaderIncludes(const std::filesystem::path& shader)
+{
+    // Follows quoted includes the way GL_GOOGLE_include_directive resolves them,
+    // relative to the including file. Angled includes have no search path to follow.
+    std::vector<std::filesystem::path> includes;
+    std::vector<std::filesystem::path> stack{shader};
+    std::set<std::filesystem::path> visited{std::filesystem::weakly_canonical(shader)};
 
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+    while (!stack.empty())
     {
-        bl::Vertex vertex{};
+        auto current = stack.back();
+        stack.pop_back();
 
-        auto& p = mesh->mVertices[i];
+        std::ifstream file(current);
+        std::string line;
 
-        vertex.position.x = p.x;
-        vertex.position.y = p.y;
-        vertex.position.z = p.z;
-
-        if (mesh->HasNormals())
+        while (std::getline(file, line))
         {
-            auto& n = mesh->mNormals[i];
-            vertex.normal.x = n.x;
-            vertex.normal.y = n.y;
-            vertex.normal.z = n.z;
-        }
+            auto start = line.find_first_not_of(" \t");
+            if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+                continue;
 
-        if (mesh->HasTextureCoords(0))
-        {
-            auto& t = mesh->mTextureCoords[0][i];
-            vertex.texCoords.x = t.x;
-            vertex.texCoords.y = t.y;
-        }
+            auto open = line.find('"', start + 8);
+            auto close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close == std::string::npos)
+                continue;
 
-        vertices.push_back(vertex);
-    }
+            auto include = std::filesystem::weakly_canonical(current.parent_path() / line.substr(open + 1, close - open - 1));
+            if (!std::filesystem::is_regular_file(include) || !visited.insert(include).second)
+                continue;
 
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
-    {
-        auto& face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++) {
-            indices.push_back(face.mIndices[j]);
+            includes.push_back(include);
+            stack.push_back(include);
         }
     }
 
-    stream.write(reinterpret_cast<char*>(vertices.data()), vertices.size());
-    stream.write(reinterpret_cast<char*>(indices.data()), indices.size());
-}
-
-void ProcessMaterials(const aiMesh* mesh, const aiScene* scene, std::ofstream& stream)
-{
+    // Keeps the dependency list stable between runs.
+    std::sort(includes.begin(), includes.end());
+    return includes;
 }
 
-bool ProcessModel(ProcessorState& state, ResourceFile& resource)
+bool ProcessShader(ProcessorState& state, ResourceFile& resource)
 {
-    auto exportedPath = (state.outputPath / resource.relativePath).replace_extension(".bmm");
-    auto exportedFilename = exportedPath.filename();
-    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path() / exportedFilename;
-
+    // Build the final absolutePath, with proper 'spv' extension.
+    auto exportedPath = state.outputPath / resource.relativePath;
     std::filesystem::create_directories(exportedPath.parent_path());
 
-    // Load the model file using ASSIMP.
-    std::ofstream out(exportedPath, std::ios::out | std::ios::binary);
+    exportedPath.replace_extension(exportedPath.extension().string() + ".spv");
+    auto exportedFilename = exportedPath.filename();
+    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path();
+    relativeExportedPath.concat("/" + exportedFilename.string());
 
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(resource.absolutePath.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_OptimizeMeshes);
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) 
+    std::string errors;
+    BakeStageTimer timer{BakeStage::eEncode};
+    if (!state.shaderCompiler->Compile(resource.absolutePath, exportedPath, errors))
     {
-        blError("ERROR::ASSIMP::{}", importer.GetErrorString());
+        blError("{}: Could not compile shader resource.\n{}", resource.relativePath, errors);
+        blWarning("This asset will not be added to the engine manifest.");
         return false;
     }
 
-    if (scene->hasSkeletons() || scene->HasAnimations())
-    {
-        blWarning("{}: Cannot process model with animations or skeletons yet.", resource.relativePath);
-        // return false;
-    }
-
-    // Write out the file header.
-    out.write("BMMF", 4);
-    bl::WriteT<uint32_t>(out, 0);
-    bl::WriteT<uint32_t>(out, scene->mNumMeshes);
-
-    // Write out the meshes.
-    ProcessNodes(scene->mRootNode, scene, out);
-
-    out.flush();
-    out.close();
-
+    // Export the final resource into the engine manifest.
     resource.bakedPath = relativeExportedPath;
     return true;
 }
+
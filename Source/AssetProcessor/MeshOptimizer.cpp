@@ -0,0 +1,151 @@
+#include <meshoptimizer.h>
+
+#include "Core/Print.h"
+#include "Graphics/ModelFormat.h"
+#include "ModelProcessor.h"
+
+// Cache size used to report ACMR/ATVR, close to the post-transform cache of most GPUs.
+static constexpr unsigned int ReportCacheSize = 16;
+
+// Lets the overdraw pass undo up to 5% of the vertex cache gains to draw front to back.
+static constexpr float OverdrawThreshold = 1.05f;
+
+// How much meshlet building favours tight normal cones over tight spheres.
+static constexpr float MeshletConeWeight = 0.25f;
+
+// A LOD removing less than this share of the previous LOD's triangles isn't worth keeping.
+static constexpr float MinLodReduction = 0.1f;
+
+struct MeshStatistics
+{
+    float acmr; // Average cache miss ratio, vertices transformed per triangle.
+    float atvr; // Average transformed vertex ratio, vertices transformed per unique vertex.
+    float overdraw; // Pixels shaded per pixel covered.
+    float overfetch; // Vertex bytes fetched per vertex byte in the mesh.
+};
+
+static MeshStatistics AnalyzeMesh(const BakedMesh& mesh)
+{
+    auto cache = meshopt_analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), ReportCacheSize, 0, 0);
+    auto overdraw = meshopt_analyzeOverdraw(mesh.indices.data(), mesh.indices.size(), &mesh.vertices[0].position.x, mesh.vertices.size(), sizeof(bl::Vertex));
+    auto fetch = meshopt_analyzeVertexFetch(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), sizeof(bl::Vertex));
+    return {cache.acmr, cache.atvr, overdraw.overdraw, fetch.overfetch};
+}
+
+void OptimizeMesh(const ResourceFile& resource, uint32_t meshIndex, BakedMesh& mesh)
+{
+    if (mesh.indices.empty() || mesh.vertices.empty())
+        return;
+
+    auto before = AnalyzeMesh(mesh);
+
+    // Triangles first, the overdraw pass works on clusters the vertex cache pass made.
+    meshopt_optimizeVertexCache(mesh.indices.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+    meshopt_optimizeOverdraw(mesh.indices.data(), mesh.indices.data(), mesh.indices.size(), &mesh.vertices[0].position.x, mesh.vertices.size(), sizeof(bl::Vertex), OverdrawThreshold);
+
+    // Then vertices in the order the triangles use them, unused vertices are dropped.
+    auto vertexCount = meshopt_optimizeVertexFetch(mesh.vertices.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size(), sizeof(bl::Vertex));
+    mesh.vertices.resize(vertexCount);
+
+    auto after = AnalyzeMesh(mesh);
+
+    blInfo("{}: Mesh {} ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, overdraw {:.3f} -> {:.3f}, overfetch {:.3f} -> {:.3f}",
+        resource.relativePath, meshIndex, before.acmr, after.acmr, before.atvr, after.atvr, before.overdraw, after.overdraw, before.overfetch, after.overfetch);
+}
+
+void GenerateLods(const ResourceFile& resource, uint32_t meshIndex, BakedMesh& mesh, const LodSettings& settings)
+{
+    mesh.lods.clear();
+    if (mesh.indices.empty() || settings.count <= 1)
+        return;
+
+    // meshoptimizer errors are relative to the mesh's size, LODs store them in mesh space.
+    float scale = meshopt_simplifyScale(&mesh.vertices[0].position.x, mesh.vertices.size(), sizeof(bl::Vertex));
+
+    mesh.lods.reserve(settings.count - 1);
+
+    const std::vector<uint32_t>* previous = &mesh.indices;
+    for (uint32_t i = 1; i < settings.count; i++)
+    {
+        size_t target = (size_t)(previous->size() * settings.ratio) / 3 * 3;
+
+        // Borders are locked so chunks of a split mesh don't open cracks between them.
+        BakedLod lod{};
+        lod.indices.resize(previous->size());
+        float error = 0.0f;
+        size_t count = meshopt_simplify(lod.indices.data(), previous->data(), previous->size(), &mesh.vertices[0].position.x,
+            mesh.vertices.size(), sizeof(bl::Vertex), target, settings.maxError, meshopt_SimplifyLockBorder, &error);
+
+        if (count == 0 || (float)count > (1.0f - MinLodReduction) * previous->size())
+            break;
+
+        lod.indices.resize(count);
+        meshopt_optimizeVertexCache(lod.indices.data(), lod.indices.data(), lod.indices.size(), mesh.vertices.size());
+
+        // Errors are measured against the LOD before, summing them keeps the bound against LOD 0.
+        float previousError = mesh.lods.empty() ? 0.0f : mesh.lods.back().error;
+        lod.error = previousError + error * scale;
+        mesh.lods.push_back(std::move(lod));
+        previous = &mesh.lods.back().indices;
+    }
+
+    std::string chain = fmt::format("{}", mesh.indices.size() / 3);
+    for (const auto& lod : mesh.lods)
+        chain += fmt::format(" -> {} ({:.4f})", lod.indices.size() / 3, lod.error);
+
+    blInfo("{}: Mesh {} LOD triangles (error) {}", resource.relativePath, meshIndex, chain);
+}
+
+void GenerateMeshlets(const ResourceFile& resource, uint32_t meshIndex, BakedMesh& mesh)
+{
+    mesh.meshlets.clear();
+    if (mesh.indices.empty())
+        return;
+
+    const float* positions = &mesh.vertices[0].position.x;
+
+    size_t maxMeshlets = meshopt_buildMeshletsBound(mesh.indices.size(), bl::ModelMeshletMaxVertices, bl::ModelMeshletMaxTriangles);
+    std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+    std::vector<uint32_t> meshletVertices(maxMeshlets * bl::ModelMeshletMaxVertices);
+    std::vector<uint8_t> meshletTriangles(maxMeshlets * bl::ModelMeshletMaxTriangles * 3);
+
+    size_t count = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(), mesh.indices.data(), mesh.indices.size(),
+        positions, mesh.vertices.size(), sizeof(bl::Vertex), bl::ModelMeshletMaxVertices, bl::ModelMeshletMaxTriangles, MeshletConeWeight);
+
+    // LOD 0 is rewritten in meshlet order so each meshlet is a range of the mesh's own
+    // indices, meshlets are spatially local so vertex cache reuse stays close.
+    std::vector<uint32_t> indices;
+    indices.reserve(mesh.indices.size());
+    mesh.meshlets.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& meshlet = meshlets[i];
+        uint32_t* vertices = &meshletVertices[meshlet.vertex_offset];
+        uint8_t* triangles = &meshletTriangles[meshlet.triangle_offset];
+
+        meshopt_optimizeMeshlet(vertices, triangles, meshlet.triangle_count, meshlet.vertex_count);
+        auto bounds = meshopt_computeMeshletBounds(vertices, triangles, meshlet.triangle_count, positions, mesh.vertices.size(), sizeof(bl::Vertex));
+
+        BakedMeshlet out{};
+        out.firstIndex = (uint32_t)indices.size();
+        out.triangleCount = meshlet.triangle_count;
+        out.vertexCount = meshlet.vertex_count;
+        out.center = {bounds.center[0], bounds.center[1], bounds.center[2]};
+        out.radius = bounds.radius;
+        out.coneApex = {bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]};
+        out.coneAxis = {bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]};
+        out.coneCutoff = bounds.cone_cutoff;
+
+        // Draws go through the regular index buffer, so local triangles become mesh indices.
+        for (size_t j = 0; j < (size_t)meshlet.triangle_count * 3; j++)
+            indices.push_back(vertices[triangles[j]]);
+
+        mesh.meshlets.push_back(out);
+    }
+
+    mesh.indices = std::move(indices);
+
+    blVerbose("{}: Mesh {} split into {} meshlets, {:.1f} triangles each.", resource.relativePath, meshIndex, count,
+        count ? (float)(mesh.indices.size() / 3) / count : 0.0f);
+}
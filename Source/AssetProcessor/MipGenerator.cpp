@@ -0,0 +1,169 @@
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BLUEMETAL_MIP_SSE2
+#endif
+
+#include "TextureProcessor.h"
+
+// Levels are filtered as linear float RGBA, premultiplied by alpha for color textures. Each
+// level is built from the float version of the level above it so rounding to 8 bits doesn't
+// add up down the chain.
+
+static float DecodeSrgb(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static float EncodeSrgb(float c)
+{
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+static std::vector<float> ToLinear(const BakedTextureLevel& level, bool srgb)
+{
+    // Alpha is always stored linearly.
+    std::array<float, 256> color, alpha;
+    for (size_t i = 0; i < 256; i++)
+    {
+        alpha[i] = (float)i / 255.0f;
+        color[i] = srgb ? DecodeSrgb(alpha[i]) : alpha[i];
+    }
+
+    std::vector<float> linear(level.pixels.size());
+    for (size_t i = 0; i < level.pixels.size(); i++)
+        linear[i] = (i % 4 == 3 ? alpha : color)[level.pixels[i]];
+
+    return linear;
+}
+
+static BakedTextureLevel FromLinear(const std::vector<float>& linear, uint32_t width, uint32_t height, bool srgb, bool premultiplied)
+{
+    BakedTextureLevel level{width, height, std::vector<uint8_t>(linear.size())};
+
+    for (size_t i = 0; i < linear.size(); i++)
+    {
+        float c = linear[i];
+
+        // A fully transparent texel has no color left to recover, it stays black.
+        if (premultiplied && i % 4 != 3)
+        {
+            float alpha = linear[i - i % 4 + 3];
+            c = alpha > 0.0f ? c / alpha : 0.0f;
+        }
+
+        c = std::clamp(c, 0.0f, 1.0f);
+        if (srgb && i % 4 != 3)
+            c = EncodeSrgb(c);
+
+        level.pixels[i] = (uint8_t)(c * 255.0f + 0.5f);
+    }
+
+    return level;
+}
+
+// The texels of the level above that one texel of a level covers, and how much of each.
+struct Taps
+{
+    uint32_t count;
+    std::array<uint32_t, 3> index;
+    std::array<float, 3> weight;
+};
+
+// An even size averages pairs. An odd size of 2n + 1 takes three texels, weighted by how
+// much of each the texel's footprint of (2n + 1) / n covers, so its last row or column
+// isn't dropped. A size of one repeats its texel.
+static Taps GetTaps(uint32_t x, uint32_t srcSize, uint32_t size)
+{
+    if (srcSize == 1)
+        return {1, {0, 0, 0}, {1.0f, 0.0f, 0.0f}};
+
+    if (srcSize % 2 == 0)
+        return {2, {x * 2, x * 2 + 1, 0}, {0.5f, 0.5f, 0.0f}};
+
+    float total = (float)srcSize;
+    return {3, {x * 2, x * 2 + 1, x * 2 + 2}, {(float)(size - x) / total, (float)size / total, (float)(x + 1) / total}};
+}
+
+// Box filters the level above, every texel of it counts exactly as much as any other.
+static std::vector<float> Downsample(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, uint32_t width, uint32_t height)
+{
+    std::vector<float> dst((size_t)width * height * 4);
+
+    std::vector<Taps> columns(width);
+    for (uint32_t x = 0; x < width; x++)
+        columns[x] = GetTaps(x, srcWidth, width);
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        auto rows = GetTaps(y, srcHeight, height);
+        float* out = &dst[(size_t)y * width * 4];
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            const auto& taps = columns[x];
+
+#ifdef BLUEMETAL_MIP_SSE2
+            // One RGBA texel per register, the taps are summed a whole texel at a time.
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t j = 0; j < rows.count; j++)
+            {
+                const float* row = &src[(size_t)rows.index[j] * srcWidth * 4];
+                for (uint32_t i = 0; i < taps.count; i++)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + (size_t)taps.index[i] * 4), _mm_set1_ps(rows.weight[j] * taps.weight[i])));
+            }
+
+            _mm_storeu_ps(out + x * 4, sum);
+#else
+            for (size_t c = 0; c < 4; c++)
+            {
+                float sum = 0.0f;
+                for (uint32_t j = 0; j < rows.count; j++)
+                {
+                    const float* row = &src[(size_t)rows.index[j] * srcWidth * 4];
+                    for (uint32_t i = 0; i < taps.count; i++)
+                        sum += row[(size_t)taps.index[i] * 4 + c] * rows.weight[j] * taps.weight[i];
+                }
+
+                out[x * 4 + c] = sum;
+            }
+#endif
+        }
+    }
+
+    return dst;
+}
+
+void GenerateMips(BakedTexture& texture)
+{
+    bool srgb = texture.pixelFormat == bl::TexturePixelFormat::eRGBA8Srgb;
+
+    texture.levels.resize(1);
+    uint32_t width = texture.levels[0].width;
+    uint32_t height = texture.levels[0].height;
+    auto linear = ToLinear(texture.levels[0], srgb);
+
+    // Color is weighted by coverage, transparent texels would otherwise bleed their color
+    // into the edges of what's drawn. Linear textures hold data, it's averaged as stored.
+    if (srgb)
+    {
+        for (size_t i = 0; i < linear.size(); i += 4)
+        {
+            for (size_t c = 0; c < 3; c++)
+                linear[i + c] *= linear[i + 3];
+        }
+    }
+
+    while (width > 1 || height > 1)
+    {
+        uint32_t levelWidth = std::max(width / 2, 1u);
+        uint32_t levelHeight = std::max(height / 2, 1u);
+
+        linear = Downsample(linear, width, height, levelWidth, levelHeight);
+        texture.levels.push_back(FromLinear(linear, levelWidth, levelHeight, srgb, srgb));
+
+        width = levelWidth;
+        height = levelHeight;
+    }
+}
@@ -0,0 +1,563 @@
+#include <cstring>
+#include <fstream>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <meshoptimizer.h>
+
+#include "Core/Print.h"
+#include "Graphics/ModelFormat.h"
+#include "BakeReport.h"
+#include "ModelProcessor.h"
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static glm::mat4 ConvertMatrix(const aiMatrix4x4& from)
+{
+    // Assimp is row major, glm and the model format are column major.
+    glm::mat4 to;
+    for (int row = 0; row < 4; row++)
+        for (int column = 0; column < 4; column++)
+            to[column][row] = from[row][column];
+    return to;
+}
+
+static glm::vec2 EncodeOctahedral(glm::vec3 n)
+{
+    // Project onto the octahedron then fold the lower half over the upper half.
+    float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (sum == 0.0f)
+        return {0.0f, 0.0f};
+
+    glm::vec2 e{n.x / sum, n.y / sum};
+    if (n.z < 0.0f)
+    {
+        e = {(1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f),
+             (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f)};
+    }
+
+    return e;
+}
+
+static bl::CompactVertex EncodeCompactVertex(const bl::Vertex& vertex, glm::vec3 min, glm::vec3 extent)
+{
+    bl::CompactVertex out{};
+
+    for (int i = 0; i < 3; i++)
+    {
+        float relative = extent[i] > 0.0f ? (vertex.position[i] - min[i]) / extent[i] : 0.0f;
+        out.position[i] = (uint16_t)meshopt_quantizeUnorm(relative, 16);
+    }
+
+    auto normal = EncodeOctahedral(vertex.normal);
+    out.normal[0] = (int16_t)meshopt_quantizeSnorm(normal.x, 16);
+    out.normal[1] = (int16_t)meshopt_quantizeSnorm(normal.y, 16);
+
+    out.texCoords[0] = meshopt_quantizeHalf(vertex.texCoords.x);
+    out.texCoords[1] = meshopt_quantizeHalf(vertex.texCoords.y);
+    return out;
+}
+
+static BakedMesh ImportMesh(const aiMesh* mesh)
+{
+    BakedMesh out{};
+    out.materialIndex = mesh->mMaterialIndex;
+    out.vertices.reserve(mesh->mNumVertices);
+    out.indices.reserve((size_t)mesh->mNumFaces * 3);
+
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+    {
+        bl::Vertex vertex{};
+
+        auto& p = mesh->mVertices[i];
+        vertex.position = {p.x, p.y, p.z};
+
+        if (mesh->HasNormals())
+        {
+            auto& n = mesh->mNormals[i];
+            vertex.normal = {n.x, n.y, n.z};
+        }
+
+        if (mesh->HasTextureCoords(0))
+        {
+            auto& t = mesh->mTextureCoords[0][i];
+            vertex.texCoords = {t.x, t.y};
+        }
+
+        out.vertices.push_back(vertex);
+    }
+
+    // Faces are all triangles after aiProcess_Triangulate, points and lines are dropped.
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+        auto& face = mesh->mFaces[i];
+        if (face.mNumIndices != 3)
+            continue;
+
+        out.indices.insert(out.indices.end(), face.mIndices, face.mIndices + 3);
+    }
+
+    return out;
+}
+
+static void ImportNodes(const aiNode* node, const aiMatrix4x4& parent, BakedModel& model)
+{
+    aiMatrix4x4 transform = parent * node->mTransformation;
+
+    if (node->mNumMeshes > 0)
+    {
+        auto transformIndex = (uint32_t)model.transforms.size();
+        model.transforms.push_back(ConvertMatrix(transform));
+
+        for (unsigned int i = 0; i < node->mNumMeshes; i++)
+            model.instances.push_back({node->mMeshes[i], transformIndex});
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+        ImportNodes(node->mChildren[i], transform, model);
+}
+
+bool ImportModel(const ResourceFile& resource, BakedModel& model)
+{
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(resource.absolutePath.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_OptimizeMeshes);
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+    {
+        blError("{}: Could not import model: {}", resource.relativePath, importer.GetErrorString());
+        return false;
+    }
+
+    if (scene->hasSkeletons() || scene->HasAnimations())
+    {
+        blWarning("{}: Cannot process model with animations or skeletons yet.", resource.relativePath);
+    }
+
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+        model.meshes.push_back(ImportMesh(scene->mMeshes[i]));
+
+    // Materials are referenced by name, the game resolves them to material resources.
+    for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+        model.materials.push_back(scene->mMaterials[i]->GetName().C_Str());
+
+    // Embedded textures are named "*index" and have no file to depend on.
+    for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+    {
+        const auto* material = scene->mMaterials[i];
+        for (int type = aiTextureType_DIFFUSE; type <= AI_TEXTURE_TYPE_MAX; type++)
+        {
+            for (unsigned int j = 0; j < material->GetTextureCount((aiTextureType)type); j++)
+            {
+                aiString path;
+                if (material->GetTexture((aiTextureType)type, j, &path) != aiReturn_SUCCESS || path.length == 0 || path.C_Str()[0] == '*')
+                    continue;
+
+                model.textures.push_back((resource.absolutePath.parent_path() / path.C_Str()).lexically_normal());
+            }
+        }
+    }
+
+    ImportNodes(scene->mRootNode, aiMatrix4x4{}, model);
+    return true;
+}
+
+void FlattenModel(const ResourceFile& resource, BakedModel& model)
+{
+    std::vector<BakedMesh> meshes;
+    std::map<uint32_t, size_t> byMaterial; // Material index to its merged mesh, in order of first use.
+
+    for (const auto& instance : model.instances)
+    {
+        const auto& mesh = model.meshes[instance.meshIndex];
+        const auto& transform = model.transforms[instance.transformIndex];
+
+        auto [it, added] = byMaterial.try_emplace(mesh.materialIndex, meshes.size());
+        if (added)
+            meshes.push_back(BakedMesh{{}, {}, mesh.materialIndex});
+
+        auto& merged = meshes[it->second];
+        auto base = (uint32_t)merged.vertices.size();
+
+        // Normals take the inverse transpose so they stay perpendicular under non uniform scale.
+        glm::mat3 normalTransform = glm::transpose(glm::inverse(glm::mat3{transform}));
+
+        for (auto vertex : mesh.vertices)
+        {
+            vertex.position = glm::vec3{transform * glm::vec4{vertex.position, 1.0f}};
+            glm::vec3 normal = normalTransform * vertex.normal;
+            float length = glm::length(normal);
+            vertex.normal = length > 0.0f ? normal / length : normal; // Meshes without normals keep zero ones.
+            merged.vertices.push_back(vertex);
+        }
+
+        // A mirroring transform turns triangles inside out, swapping two corners turns them back.
+        bool mirrored = glm::determinant(glm::mat3{transform}) < 0.0f;
+
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+        {
+            merged.indices.push_back(base + mesh.indices[t]);
+            merged.indices.push_back(base + mesh.indices[t + (mirrored ? 2 : 1)]);
+            merged.indices.push_back(base + mesh.indices[t + (mirrored ? 1 : 2)]);
+        }
+    }
+
+    blVerbose("{}: Flattened {} instances of {} meshes into {} meshes.", resource.relativePath, model.instances.size(), model.meshes.size(), meshes.size());
+
+    model.instances.clear();
+    for (uint32_t i = 0; i < (uint32_t)meshes.size(); i++)
+        model.instances.push_back({i, 0});
+
+    model.meshes = std::move(meshes);
+    model.transforms = {glm::mat4{1.0f}};
+}
+
+void SplitLargeMeshes(const ResourceFile& resource, BakedModel& model)
+{
+    std::vector<BakedMesh> meshes;
+    std::vector<std::pair<uint32_t, uint32_t>> chunks(model.meshes.size()); // First chunk and chunk count of each mesh.
+
+    for (size_t i = 0; i < model.meshes.size(); i++)
+    {
+        auto& mesh = model.meshes[i];
+
+        if (mesh.vertices.size() <= MaxShortIndexVertices)
+        {
+            chunks[i] = {(uint32_t)meshes.size(), 1};
+            meshes.push_back(std::move(mesh));
+            continue;
+        }
+
+        // Triangles are taken in order so each chunk keeps the vertex cache order and its
+        // vertices are in first use order, the same order the fetch optimization leaves.
+        std::vector<uint32_t> remap(mesh.vertices.size(), UINT32_MAX);
+        std::vector<uint32_t> used;
+        BakedMesh chunk{{}, {}, mesh.materialIndex};
+
+        auto flush = [&](){
+            for (auto index : used)
+                remap[index] = UINT32_MAX;
+
+            used.clear();
+            meshes.push_back(std::move(chunk));
+            chunk = BakedMesh{{}, {}, mesh.materialIndex};
+        };
+
+        chunks[i].first = (uint32_t)meshes.size();
+
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+        {
+            const uint32_t* triangle = &mesh.indices[t];
+
+            size_t added = 0;
+            for (int j = 0; j < 3; j++)
+                added += remap[triangle[j]] == UINT32_MAX && std::find(triangle, triangle + j, triangle[j]) == triangle + j;
+
+            if (chunk.vertices.size() + added > MaxShortIndexVertices)
+                flush();
+
+            for (int j = 0; j < 3; j++)
+            {
+                auto& index = remap[triangle[j]];
+                if (index == UINT32_MAX)
+                {
+                    index = (uint32_t)chunk.vertices.size();
+                    chunk.vertices.push_back(mesh.vertices[triangle[j]]);
+                    used.push_back(triangle[j]);
+                }
+
+                chunk.indices.push_back(index);
+            }
+        }
+
+        if (!chunk.indices.empty())
+            flush();
+
+        chunks[i].second = (uint32_t)meshes.size() - chunks[i].first;
+        blVerbose("{}: Mesh {} has {} vertices, split into {} chunks for 16 bit indices.", resource.relativePath, i, mesh.vertices.size(), chunks[i].second);
+    }
+
+    // Every instance of a split mesh draws all of its chunks.
+    std::vector<BakedInstance> instances;
+    for (const auto& instance : model.instances)
+    {
+        auto [first, count] = chunks[instance.meshIndex];
+        for (uint32_t j = 0; j < count; j++)
+            instances.push_back({first + j, instance.transformIndex});
+    }
+
+    model.meshes = std::move(meshes);
+    model.instances = std::move(instances);
+}
+
+bool WriteModel(const BakedModel& model, const std::filesystem::path& path)
+{
+    struct Section
+    {
+        bl::ModelSection header;
+        std::vector<std::byte> data;
+    };
+
+    auto makeSection = [](bl::ModelSectionType type, uint32_t count, uint32_t stride){
+        Section section{};
+        section.header.type = type;
+        section.header.count = count;
+        section.header.stride = stride;
+        return section;
+    };
+
+    auto append = [](std::vector<std::byte>& to, const void* data, size_t size){
+        auto bytes = static_cast<const std::byte*>(data);
+        to.insert(to.end(), bytes, bytes + size);
+    };
+
+    // Geometry is written once per mesh, every instance of it points at the same ranges.
+    std::vector<bl::ModelMesh> geometry(model.meshes.size());
+    Section vertices = makeSection(bl::ModelSectionType::eVertices, 0, 0);
+    Section indices = makeSection(bl::ModelSectionType::eIndices, 0, 0);
+    Section lods = makeSection(bl::ModelSectionType::eLods, 0, sizeof(bl::ModelLod));
+    Section meshlets = makeSection(bl::ModelSectionType::eMeshlets, 0, sizeof(bl::ModelMeshlet));
+
+    for (size_t i = 0; i < model.meshes.size(); i++)
+    {
+        const auto& mesh = model.meshes[i];
+
+        glm::vec3 min{0.0f}, max{0.0f};
+        if (!mesh.vertices.empty())
+            min = max = mesh.vertices[0].position;
+
+        for (const auto& vertex : mesh.vertices)
+        {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+
+        auto& out = geometry[i];
+        out.vertexOffset = vertices.data.size();
+        out.vertexCount = (uint32_t)mesh.vertices.size();
+        out.indexCount = (uint32_t)mesh.indices.size();
+        out.indexSize = mesh.vertices.size() <= MaxShortIndexVertices ? sizeof(uint16_t) : sizeof(uint32_t);
+        out.materialIndex = mesh.materialIndex;
+        out.vertexFormat = (uint32_t)model.vertexFormat;
+        std::memcpy(out.boundsMin, &min, sizeof(out.boundsMin));
+        std::memcpy(out.boundsMax, &max, sizeof(out.boundsMax));
+
+        if (model.vertexFormat == bl::VertexFormat::eCompact)
+        {
+            out.vertexStride = sizeof(bl::CompactVertex);
+            for (const auto& vertex : mesh.vertices)
+            {
+                auto compact = EncodeCompactVertex(vertex, min, max - min);
+                append(vertices.data, &compact, sizeof(compact));
+            }
+        }
+        else
+        {
+            out.vertexStride = sizeof(bl::Vertex);
+            append(vertices.data, mesh.vertices.data(), mesh.vertices.size() * sizeof(bl::Vertex));
+        }
+
+        // Four byte aligned ranges let both index types share one buffer at runtime.
+        auto appendIndices = [&](const std::vector<uint32_t>& from){
+            indices.data.resize(AlignUp(indices.data.size(), sizeof(uint32_t)));
+            uint64_t offset = indices.data.size();
+
+            if (out.indexSize == sizeof(uint16_t))
+            {
+                std::vector<uint16_t> shortIndices(from.begin(), from.end());
+                append(indices.data, shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+            }
+            else
+            {
+                append(indices.data, from.data(), from.size() * sizeof(uint32_t));
+            }
+
+            indices.header.count += (uint32_t)from.size();
+            return offset;
+        };
+
+        out.indexOffset = appendIndices(mesh.indices);
+
+        // LOD 0 is listed too so every mesh's chain is complete in the lods section.
+        out.firstLod = lods.header.count;
+        out.lodCount = 1 + (uint32_t)mesh.lods.size();
+
+        bl::ModelLod base{out.indexOffset, out.indexCount, 0.0f};
+        append(lods.data, &base, sizeof(base));
+
+        for (const auto& lod : mesh.lods)
+        {
+            bl::ModelLod entry{appendIndices(lod.indices), (uint32_t)lod.indices.size(), lod.error};
+            append(lods.data, &entry, sizeof(entry));
+        }
+
+        lods.header.count += out.lodCount;
+
+        out.firstMeshlet = meshlets.header.count;
+        out.meshletCount = (uint32_t)mesh.meshlets.size();
+
+        if (!mesh.meshlets.empty())
+        {
+            // Meshlets are ranges of LOD 0, GenerateMeshlets put its triangles in meshlet order.
+            for (const auto& meshlet : mesh.meshlets)
+            {
+                bl::ModelMeshlet entry{};
+                entry.indexOffset = out.indexOffset + (uint64_t)meshlet.firstIndex * out.indexSize;
+                entry.triangleCount = meshlet.triangleCount;
+                entry.vertexCount = meshlet.vertexCount;
+                std::memcpy(entry.center, &meshlet.center, sizeof(entry.center));
+                entry.radius = meshlet.radius;
+                std::memcpy(entry.coneApex, &meshlet.coneApex, sizeof(entry.coneApex));
+                std::memcpy(entry.coneAxis, &meshlet.coneAxis, sizeof(entry.coneAxis));
+                entry.coneCutoff = meshlet.coneCutoff;
+                append(meshlets.data, &entry, sizeof(entry));
+            }
+
+            meshlets.header.count += out.meshletCount;
+        }
+        vertices.header.count += out.vertexCount;
+    }
+
+    Section meshes = makeSection(bl::ModelSectionType::eMeshes, (uint32_t)model.instances.size(), sizeof(bl::ModelMesh));
+    for (const auto& instance : model.instances)
+    {
+        auto mesh = geometry[instance.meshIndex];
+        mesh.transformIndex = instance.transformIndex;
+        append(meshes.data, &mesh, sizeof(mesh));
+    }
+
+    Section transforms = makeSection(bl::ModelSectionType::eTransforms, (uint32_t)model.transforms.size(), sizeof(bl::ModelMatrix));
+    append(transforms.data, model.transforms.data(), model.transforms.size() * sizeof(bl::ModelMatrix));
+
+    Section materials = makeSection(bl::ModelSectionType::eMaterials, (uint32_t)model.materials.size(), sizeof(bl::ModelMaterial));
+    Section strings = makeSection(bl::ModelSectionType::eStrings, 0, 0);
+    for (const auto& name : model.materials)
+    {
+        bl::ModelMaterial material{(uint32_t)strings.data.size(), (uint32_t)name.size()};
+        append(materials.data, &material, sizeof(material));
+        append(strings.data, name.data(), name.size());
+    }
+
+    std::vector<Section*> sections = {&meshes, &lods, &transforms, &materials, &strings, &vertices, &indices};
+    if (meshlets.header.count > 0)
+        sections.push_back(&meshlets);
+
+    uint64_t offset = sizeof(bl::ModelHeader) + sections.size() * sizeof(bl::ModelSection);
+    for (auto* section : sections)
+    {
+        offset = AlignUp(offset, bl::ModelAlignment);
+        section->header.offset = offset;
+        section->header.size = section->data.size();
+        offset += section->data.size();
+    }
+
+    bl::ModelHeader header{};
+    std::memcpy(header.magic, "BMMF", 4);
+    header.version = bl::ModelVersion;
+    header.numSections = (uint32_t)sections.size();
+
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto* section : sections)
+        out.write(reinterpret_cast<const char*>(&section->header), sizeof(bl::ModelSection));
+
+    static const char padding[bl::ModelAlignment] = {};
+    for (auto* section : sections)
+    {
+        out.write(padding, (std::streamsize)(section->header.offset - (uint64_t)out.tellp()));
+        out.write(reinterpret_cast<const char*>(section->data.data()), (std::streamsize)section->data.size());
+    }
+
+    return (bool)out;
+}
+
+bool ProcessModel(ProcessorState& state, ResourceFile& resource)
+{
+    auto exportedPath = (state.outputPath / resource.relativePath).replace_extension(".bmm");
+    auto exportedFilename = exportedPath.filename();
+    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path() / exportedFilename;
+
+    std::filesystem::create_directories(exportedPath.parent_path());
+
+    BakedModel model;
+    {
+        BakeStageTimer timer{BakeStage::eImport};
+        if (!ImportModel(resource, model))
+            return false;
+    }
+
+    // Textures the materials use that are in the manifest are loaded along with the model.
+    auto manifestRoot = state.manifestPath.parent_path().lexically_normal();
+    resource.references.clear();
+
+    for (const auto& texture : model.textures)
+    {
+        auto path = texture.lexically_relative(manifestRoot).generic_string();
+        if (state.resourceChecker.contains(path) && std::find(resource.references.begin(), resource.references.end(), path) == resource.references.end())
+            resource.references.push_back(path);
+    }
+
+    // "vertexFormat": "Compact" bakes 16 byte quantized vertices, see bl::CompactVertex.
+    auto vertexFormat = resource.properties.value("vertexFormat", "Full");
+    if (vertexFormat == "Compact")
+    {
+        model.vertexFormat = bl::VertexFormat::eCompact;
+    }
+    else if (vertexFormat != "Full")
+    {
+        blError("{}: Unknown vertex format {}, expected Full or Compact.", resource.relativePath, vertexFormat);
+        return false;
+    }
+
+    // "flatten": true merges the node hierarchy into one mesh per material, for static models.
+    if (resource.properties.value("flatten", false))
+        FlattenModel(resource, model);
+
+    LodSettings lodSettings;
+    lodSettings.count = resource.properties.value("lodCount", lodSettings.count);
+    lodSettings.ratio = resource.properties.value("lodRatio", lodSettings.ratio);
+    lodSettings.maxError = resource.properties.value("lodMaxError", lodSettings.maxError);
+
+    {
+        BakeStageTimer timer{BakeStage::eOptimize};
+
+        // On unless the manifest turns it off with "optimize": false.
+        if (resource.properties.value("optimize", true))
+        {
+            for (size_t i = 0; i < model.meshes.size(); i++)
+                OptimizeMesh(resource, (uint32_t)i, model.meshes[i]);
+        }
+
+        // Meshes too large for 16 bit indices keep 32 bit ones unless "splitMeshes" is set.
+        if (resource.properties.value("splitMeshes", false))
+            SplitLargeMeshes(resource, model);
+
+        for (size_t i = 0; i < model.meshes.size(); i++)
+            GenerateLods(resource, (uint32_t)i, model.meshes[i], lodSettings);
+
+        // "meshlets": true adds per meshlet culling bounds, worth it for large meshes.
+        if (resource.properties.value("meshlets", false))
+        {
+            for (size_t i = 0; i < model.meshes.size(); i++)
+                GenerateMeshlets(resource, (uint32_t)i, model.meshes[i]);
+        }
+    }
+
+    BakeStageTimer timer{BakeStage::eWrite};
+    if (!WriteModel(model, exportedPath))
+    {
+        blError("{}: Could not write the baked model.", resource.relativePath);
+        return false;
+    }
+
+    blVerbose("{}: Baked {} meshes, {} instances and {} materials.", resource.relativePath, model.meshes.size(), model.instances.size(), model.materials.size());
+
+    resource.bakedPath = relativeExportedPath;
+    return true;
+}
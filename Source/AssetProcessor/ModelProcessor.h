@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Graphics/Vertex.h"
+#include "AssetProcessor.h"
+
+// The model being baked, imported from assimp and written out as BMMF once every
+// processing step has run over it, see Graphics/ModelFormat.h.
+
+// Meshes with at most this many vertices are written with 16 bit indices.
+constexpr size_t MaxShortIndexVertices = 65536;
+
+// A coarser version of a mesh drawing the same vertices with fewer triangles.
+struct BakedLod
+{
+    std::vector<uint32_t> indices;
+    float error; // Mesh space distance the surface moved from the full mesh.
+};
+
+// A cluster of a mesh's triangles small enough to be culled on its own.
+struct BakedMeshlet
+{
+    uint32_t firstIndex; // Into BakedMesh::indices, LOD 0.
+    uint32_t triangleCount;
+    uint32_t vertexCount;
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneApex;
+    glm::vec3 coneAxis;
+    float coneCutoff;
+};
+
+struct BakedMesh
+{
+    std::vector<bl::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    uint32_t materialIndex; // Index into BakedModel::materials or bl::ModelNoMaterial.
+    std::vector<BakedLod> lods; // LOD 1 and coarser, LOD 0 is the mesh's own indices.
+    std::vector<BakedMeshlet> meshlets;
+};
+
+// Controls the LOD chain built by GenerateLods.
+struct LodSettings
+{
+    uint32_t count = 4; // LOD 0 included, 1 turns LODs off.
+    float ratio = 0.5f; // Target index count of each LOD relative to the one before it.
+    float maxError = 0.05f; // Largest error allowed relative to the mesh's size.
+};
+
+// A mesh placed in the model, meshes used by more than one node are stored once.
+struct BakedInstance
+{
+    uint32_t meshIndex;
+    uint32_t transformIndex;
+};
+
+struct BakedModel
+{
+    std::vector<BakedMesh> meshes;
+    std::vector<BakedInstance> instances;
+    std::vector<glm::mat4> transforms; // Model space, parent transforms already applied.
+    std::vector<std::string> materials;
+    std::vector<std::filesystem::path> textures; // Files the materials reference, not written into the model.
+    bl::VertexFormat vertexFormat = bl::VertexFormat::eFull; // The layout vertices are written in.
+};
+
+bool ImportModel(const ResourceFile& resource, BakedModel& model);
+
+// Reorders triangles for the vertex cache and overdraw then vertices for fetch locality,
+// logging ACMR/ATVR before and after. See MeshOptimizer.cpp.
+void OptimizeMesh(const ResourceFile& resource, uint32_t meshIndex, BakedMesh& mesh);
+
+// Builds a mesh's LOD chain by error bounded simplification, stopping early once a LOD
+// can't get meaningfully smaller within the error bound. See MeshOptimizer.cpp.
+void GenerateLods(const ResourceFile& resource, uint32_t meshIndex, BakedMesh& mesh, const LodSettings& settings);
+
+// Splits LOD 0 of a mesh into meshlets of at most bl::ModelMeshletMaxVertices vertices and
+// bl::ModelMeshletMaxTriangles triangles, each with a bounding sphere and normal cone. LOD 0's
+// indices are reordered so every meshlet is a contiguous range of them.
+void GenerateMeshlets(const ResourceFile& resource, uint32_t meshIndex, BakedMesh& mesh);
+
+// Bakes every instance's transform into its vertices and merges instances sharing a
+// material into one mesh, leaving a single identity transform. Only for models that are
+// never animated by node, the model then draws once per material instead of once per node.
+void FlattenModel(const ResourceFile& resource, BakedModel& model);
+
+// Splits meshes with more vertices than 16 bit indices address into chunks that fit,
+// the instances of a split mesh draw every chunk.
+void SplitLargeMeshes(const ResourceFile& resource, BakedModel& model);
+
+bool WriteModel(const BakedModel& model, const std::filesystem::path& path);
@@ -0,0 +1,323 @@
+#include "Core/Hash.h"
+#include "Core/Print.h"
+#include "Core/ThreadPool.h"
+#include "Resource/Compression.h"
+#include "Resource/Manifest.h"
+#include "Resource/PackFormat.h"
+#include "PackWriter.h"
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string GetManifestPath(const ResourceFile& resource)
+{
+    if (resource.bakedPath.empty())
+        return std::filesystem::path(resource.relativePath).generic_string();
+
+    return resource.bakedPath.generic_string();
+}
+
+std::filesystem::path GetManifestFile(const ProcessorState& state, const ResourceFile& resource)
+{
+    if (resource.bakedPath.empty())
+        return resource.absolutePath;
+
+    return state.outputPath / resource.bakedPath;
+}
+
+bool WritePack(const ProcessorState& state, const std::vector<const ResourceFile*>& resources, const std::filesystem::path& packPath, const bl::Codec* codec)
+{
+    struct PendingEntry
+    {
+        bl::PackEntry entry;
+        std::filesystem::path file;
+        std::string path;
+    };
+
+    // Payloads are laid out group by group so each group is one sequential read, then
+    // the rest in manifest order. The table of contents is sorted by hash.
+    std::vector<const ResourceFile*> layout;
+    std::unordered_set<const ResourceFile*> placed;
+
+    for (const auto& [name, paths] : state.groups)
+    {
+        for (const auto& path : paths)
+        {
+            auto resource = std::find_if(resources.begin(), resources.end(), [&](const auto* r){ return r->relativePath == path; });
+            if (resource != resources.end() && placed.insert(*resource).second)
+                layout.push_back(*resource);
+        }
+    }
+
+    for (const auto* resource : resources)
+    {
+        if (placed.insert(resource).second)
+            layout.push_back(resource);
+    }
+
+    std::vector<PendingEntry> pending;
+    pending.reserve(layout.size());
+
+    for (const auto* resource : layout)
+    {
+        PendingEntry pendingEntry{};
+        pendingEntry.path = GetManifestPath(*resource);
+        pendingEntry.file = GetManifestFile(state, *resource);
+        pendingEntry.entry.pathHash = bl::Hash64(pendingEntry.path);
+        pending.push_back(std::move(pendingEntry));
+    }
+
+    // Two paths with the same hash can't be told apart at runtime.
+    std::unordered_map<uint64_t, const PendingEntry*> byHash;
+    for (const auto& pendingEntry : pending)
+    {
+        auto [other, inserted] = byHash.try_emplace(pendingEntry.entry.pathHash, &pendingEntry);
+        if (!inserted)
+        {
+            blError("{}: Path hash collides with {}, rename one of them.", pendingEntry.path, other->second->path);
+            return false;
+        }
+    }
+
+    uint64_t tocOffset = sizeof(bl::PackHeader);
+    uint64_t dataOffset = AlignUp(tocOffset + pending.size() * sizeof(bl::PackEntry), bl::PackAlignment);
+
+    // Write then swap so a running game never maps a half written pack.
+    auto temporaryPath = packPath;
+    temporaryPath += ".tmp";
+
+    std::ofstream out(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        blError("Could not open the resource pack for writing: {}", packPath.string());
+        return false;
+    }
+
+    static const char padding[bl::PackAlignment] = {};
+    auto pad = [&](uint64_t to){
+        uint64_t at = (uint64_t)out.tellp();
+        out.write(padding, (std::streamsize)(to - at));
+    };
+
+    // Compressed sizes are only known once each payload is compressed, so payloads are
+    // written as they come and the header and table of contents go in last.
+    pad(dataOffset);
+
+    std::unique_ptr<bl::ThreadPool> pool;
+    if (codec)
+        pool = std::make_unique<bl::ThreadPool>();
+
+    uint64_t offset = dataOffset;
+    uint64_t uncompressedSize = 0;
+    uint32_t numCompressed = 0;
+
+    std::vector<std::byte> buffer;
+    for (auto& pendingEntry : pending)
+    {
+        std::ifstream in(pendingEntry.file, std::ios::binary);
+        buffer.resize(std::filesystem::file_size(pendingEntry.file));
+        in.read(reinterpret_cast<char*>(buffer.data()), (std::streamsize)buffer.size());
+
+        if (!in)
+        {
+            blError("{}: Could not be read into the resource pack.", pendingEntry.path);
+            return false;
+        }
+
+        std::span<const std::byte> payload = buffer;
+        std::vector<std::byte> compressed;
+
+        // A compressed payload is decompressed into a copy instead of read in place, it
+        // has to save enough to be worth that. Already compressed audio rarely does.
+        if (codec)
+        {
+            compressed = bl::Compress(buffer, *codec, bl::DefaultChunkSize, pool.get());
+            if (compressed.size() < buffer.size() - buffer.size() / 8)
+            {
+                payload = compressed;
+                pendingEntry.entry.flags |= bl::PackEntryCompressed;
+                numCompressed++;
+            }
+        }
+
+        pad(offset);
+        out.write(reinterpret_cast<const char*>(payload.data()), (std::streamsize)payload.size());
+
+        pendingEntry.entry.offset = offset;
+        pendingEntry.entry.size = payload.size();
+        uncompressedSize += buffer.size();
+        offset = AlignUp(offset + payload.size(), bl::PackAlignment);
+    }
+
+    std::vector<bl::PackEntry> toc;
+    toc.reserve(pending.size());
+    for (const auto& pendingEntry : pending)
+        toc.push_back(pendingEntry.entry);
+
+    std::sort(toc.begin(), toc.end(), [](const auto& a, const auto& b){ return a.pathHash < b.pathHash; });
+
+    bl::PackHeader header{};
+    std::memcpy(header.magic, "BPAK", 4);
+    header.version = bl::PackVersion;
+    header.numEntries = (uint32_t)toc.size();
+    header.alignment = bl::PackAlignment;
+    header.tocOffset = tocOffset;
+    header.dataOffset = dataOffset;
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(toc.data()), (std::streamsize)(toc.size() * sizeof(bl::PackEntry)));
+
+    out.close();
+    if (!out)
+    {
+        blError("Could not write the resource pack: {}", packPath.string());
+        return false;
+    }
+
+    // The game may have the old pack open or mapped, on Windows that fails the swap.
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, packPath, error);
+    if (error)
+    {
+        blError("Could not replace the resource pack {}: {}", packPath.string(), error.message());
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    if (codec)
+        blInfo("Packed {} resources into {} ({} bytes), {} compressed with {} from {} bytes.", pending.size(), packPath.string(), offset, numCompressed, codec->GetName(), uncompressedSize);
+    else
+        blInfo("Packed {} resources into {} ({} bytes).", pending.size(), packPath.string(), offset);
+
+    return true;
+}
+
+bool WriteEngineManifest(const ProcessorState& state, const std::vector<const ResourceFile*>& resources, const std::vector<std::string>& packs)
+{
+    nlohmann::json root;
+    root["Packs"] = packs;
+    root["Resources"] = nlohmann::json::array();
+
+    std::unordered_map<std::string, const ResourceFile*> bySourcePath;
+    for (const auto* resource : resources)
+        bySourcePath[resource->relativePath] = resource;
+
+    for (const auto* resource : resources)
+    {
+        nlohmann::json object;
+
+        // The source manifest uses lower case keys, the engine capitalizes them.
+        for (const auto& [key, value] : resource->properties.items())
+        {
+            if (key.empty() || key == "path" || key == "type" || key == "dependencies")
+                continue;
+
+            auto engineKey = key;
+            engineKey[0] = (char)std::toupper((unsigned char)engineKey[0]);
+            object[engineKey] = value;
+        }
+
+        object["Path"] = GetManifestPath(*resource);
+        object["Type"] = resource->type;
+
+        // Dependencies from the source manifest and found by the bake are source paths, the engine knows them by their baked ones.
+        auto sources = resource->properties.value("dependencies", std::vector<std::string>{});
+        sources.insert(sources.end(), resource->references.begin(), resource->references.end());
+
+        std::vector<std::string> dependencies;
+        for (const auto& source : sources)
+        {
+            auto dependency = bySourcePath.find(source);
+            if (dependency == bySourcePath.end())
+            {
+                blWarning("{}: Dependency {} isn't in the engine manifest, leaving it out.", resource->relativePath, source);
+                continue;
+            }
+
+            auto path = GetManifestPath(*dependency->second);
+            if (std::find(dependencies.begin(), dependencies.end(), path) == dependencies.end())
+                dependencies.push_back(path);
+        }
+
+        if (!dependencies.empty())
+            object["Dependencies"] = dependencies;
+
+        root["Resources"].push_back(std::move(object));
+    }
+
+    // Group members that weren't processed have nothing to load and are left out.
+    root["Groups"] = nlohmann::json::array();
+    for (const auto& [name, paths] : state.groups)
+    {
+        std::vector<std::string> members;
+        for (const auto& path : paths)
+        {
+            if (auto member = bySourcePath.find(path); member != bySourcePath.end())
+                members.push_back(GetManifestPath(*member->second));
+        }
+
+        root["Groups"].push_back({{"Name", name}, {"Resources", members}});
+    }
+
+    std::ofstream out(state.outputPath / "Manifest.json", std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+    {
+        blError("Could not open the engine manifest for writing.");
+        return false;
+    }
+
+    out << root.dump(4);
+    out.close();
+    if (!out)
+    {
+        blError("Could not write the engine manifest.");
+        return false;
+    }
+
+    // The binary manifest is what the engine maps, Manifest.json is kept for people to read.
+    std::vector<std::byte> binary;
+    try
+    {
+        binary = bl::Manifest::Build(root);
+    }
+    catch (const std::exception& e)
+    {
+        blError("Could not build the binary engine manifest: {}", e.what());
+        return false;
+    }
+
+    auto binaryPath = state.outputPath / "Manifest.bman";
+    auto temporaryPath = binaryPath;
+    temporaryPath += ".tmp";
+
+    std::ofstream binaryOut(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!binaryOut.is_open())
+    {
+        blError("Could not open the binary engine manifest for writing.");
+        return false;
+    }
+
+    binaryOut.write(reinterpret_cast<const char*>(binary.data()), (std::streamsize)binary.size());
+    binaryOut.close();
+
+    std::error_code error;
+    if (!binaryOut)
+    {
+        blError("Could not write the binary engine manifest.");
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporaryPath, binaryPath, error);
+    if (error)
+    {
+        blError("Could not replace the binary engine manifest {}: {}", binaryPath.string(), error.message());
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "AssetProcessor.h"
+#include "Resource/Compression.h"
+
+// Returns the path a resource is known by in the engine manifest and packs, its baked
+// path or its source path when it wasn't baked.
+std::string GetManifestPath(const ResourceFile& resource);
+
+// Returns the file holding what the engine should load for a resource.
+std::filesystem::path GetManifestFile(const ProcessorState& state, const ResourceFile& resource);
+
+// Writes every processed resource into one memory mappable pack, see Resource/PackFormat.h.
+// With a codec, payloads that shrink enough are stored in compressed chunks instead.
+bool WritePack(const ProcessorState& state, const std::vector<const ResourceFile*>& resources, const std::filesystem::path& packPath, const bl::Codec* codec = nullptr);
+
+// Writes the manifest the engine loads resources from as Manifest.json and Manifest.bman, see Resource/ResourceManager.h.
+bool WriteEngineManifest(const ProcessorState& state, const std::vector<const ResourceFile*>& resources, const std::vector<std::string>& packs);
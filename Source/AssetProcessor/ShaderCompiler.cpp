@@ -0,0 +1,224 @@
+#include <cstdio>
+
+#include "Core/Platform.h"
+#include "Core/Print.h"
+#include "ShaderCompiler.h"
+
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    #define popen _popen
+    #define pclose _pclose
+#endif
+
+#ifdef BLUEMETAL_SHADERC
+#include <shaderc/shaderc.hpp>
+
+// Resolves quoted includes relative to the including file the same way glslc does,
+// contents come out of the compiler's shared include cache.
+class ShaderIncluder : public shaderc::CompileOptions::IncluderInterface
+{
+public:
+    ShaderIncluder(ShaderCompiler* compiler)
+        : _compiler(compiler)
+    {
+    }
+
+    virtual shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t) override
+    {
+        auto* include = new Include{};
+
+        std::filesystem::path path = requestedSource;
+        if (type == shaderc_include_type_relative)
+            path = std::filesystem::path(requestingSource).parent_path() / requestedSource;
+
+        if (std::filesystem::is_regular_file(path))
+        {
+            include->name = std::filesystem::weakly_canonical(path).string();
+            include->content = _compiler->ReadInclude(include->name);
+        }
+        else
+        {
+            // An empty name tells shaderc the include failed, the content is the error.
+            include->content = std::make_shared<const std::string>(fmt::format("Could not find include: {}", requestedSource));
+        }
+
+        include->result.source_name = include->name.c_str();
+        include->result.source_name_length = include->name.size();
+        include->result.content = include->content->c_str();
+        include->result.content_length = include->content->size();
+        include->result.user_data = include;
+        return &include->result;
+    }
+
+    virtual void ReleaseInclude(shaderc_include_result* data) override
+    {
+        delete static_cast<Include*>(data->user_data);
+    }
+
+private:
+    struct Include
+    {
+        shaderc_include_result result;
+        std::string name;
+        std::shared_ptr<const std::string> content;
+    };
+
+    ShaderCompiler* _compiler;
+};
+
+static std::optional<shaderc_shader_kind> GetShaderKind(const std::filesystem::path& source)
+{
+    auto extension = source.extension().string();
+    if (extension == ".vert") return shaderc_vertex_shader;
+    if (extension == ".frag") return shaderc_fragment_shader;
+    if (extension == ".comp") return shaderc_compute_shader;
+    if (extension == ".geom") return shaderc_geometry_shader;
+    if (extension == ".tesc") return shaderc_tess_control_shader;
+    if (extension == ".tese") return shaderc_tess_evaluation_shader;
+    return std::nullopt;
+}
+#endif
+
+// Runs a shell command with its error output joined to its output, so nothing it prints
+// reaches the terminal outside of the bake job's log capture. Returns the exit status.
+static int RunCommand(const std::string& command, std::string& output)
+{
+    FILE* pipe = popen(fmt::format("{} 2>&1", command).c_str(), "r");
+    if (!pipe)
+        return -1;
+
+    char buffer[4096];
+    while (size_t read = std::fread(buffer, 1, sizeof(buffer), pipe))
+        output.append(buffer, read);
+
+    return pclose(pipe);
+}
+
+ShaderCompiler::ShaderCompiler()
+    : _compiler(nullptr)
+{
+#ifdef BLUEMETAL_SHADERC
+    _compiler = new shaderc::Compiler{};
+
+    // The revision is the generator's, it changes with the glslang shaderc was built from.
+    unsigned int version = 0;
+    unsigned int revision = 0;
+    shaderc_get_spv_version(&version, &revision);
+    _backend = fmt::format("shaderc SPIR-V {:x} revision {}", version, revision);
+#else
+    // Its first line names the shaderc and glslang releases it was built from.
+    std::string output;
+    if (RunCommand("glslc --version", output) == EXIT_SUCCESS)
+        _backend = output.substr(0, output.find('\n'));
+    else
+        _backend = "glslc";
+#endif
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+#ifdef BLUEMETAL_SHADERC
+    delete static_cast<shaderc::Compiler*>(_compiler);
+#endif
+}
+
+bool ShaderCompiler::IsInProcess() const
+{
+    return _compiler != nullptr;
+}
+
+const std::string& ShaderCompiler::GetBackend() const
+{
+    return _backend;
+}
+
+static std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::shared_ptr<const std::string> ShaderCompiler::ReadInclude(const std::filesystem::path& path)
+{
+    auto name = std::filesystem::weakly_canonical(path).string();
+
+    // Stamped before reading, an edit landing during the read is caught by the next lookup.
+    std::error_code error;
+    Source source;
+    source.size = std::filesystem::file_size(path, error);
+    source.time = std::filesystem::last_write_time(path, error);
+
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _sources.find(name);
+        if (it != _sources.end() && it->second.size == source.size && it->second.time == source.time)
+            return it->second.content;
+    }
+
+    // Read outside of the lock, two jobs reading the same file at once is harmless.
+    source.content = std::make_shared<const std::string>(ReadFile(path));
+
+    std::lock_guard lock(_mutex);
+    _sources.insert_or_assign(name, source);
+    return source.content;
+}
+
+void ShaderCompiler::Forget(const std::vector<std::filesystem::path>& paths)
+{
+    std::lock_guard lock(_mutex);
+    for (const auto& path : paths)
+        _sources.erase(std::filesystem::weakly_canonical(path).string());
+}
+
+bool ShaderCompiler::Compile(const std::filesystem::path& source, const std::filesystem::path& output, std::string& errors)
+{
+#ifdef BLUEMETAL_SHADERC
+    auto kind = GetShaderKind(source);
+    if (!kind)
+    {
+        errors = fmt::format("Unknown shader stage for extension: {}", source.extension().string());
+        return false;
+    }
+
+    // Matches glslc's defaults so the SPIR-V is the same whichever way it's compiled.
+    shaderc::CompileOptions options;
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
+    options.SetIncluder(std::make_unique<ShaderIncluder>(this));
+
+    // The shaderc compiler is safe to share between threads, options are per call.
+    auto* compiler = static_cast<shaderc::Compiler*>(_compiler);
+    // The shader itself is read fresh every time, only what it includes is shared.
+    auto code = ReadFile(source);
+    auto result = compiler->CompileGlslToSpv(code.data(), code.size(), *kind, source.string().c_str(), "main", options);
+
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+    {
+        errors = result.GetErrorMessage();
+        return false;
+    }
+
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(result.cbegin()), (std::streamsize)((result.cend() - result.cbegin()) * sizeof(uint32_t)));
+    return (bool)out;
+#else
+    return CompileExternal(source, output, errors);
+#endif
+}
+
+bool ShaderCompiler::CompileExternal(const std::filesystem::path& source, const std::filesystem::path& output, std::string& errors)
+{
+    // Run the glslc shader compilation command.
+    std::string cmd = fmt::format("glslc \"{}\" -o \"{}\"", source.string(), output.string());
+    std::string messages;
+
+    if (RunCommand(cmd, messages) != EXIT_SUCCESS)
+    {
+        errors = messages.empty() ? "glslc failed, please ensure that you have the Vulkan SDK Installed." : messages;
+        return false;
+    }
+
+    // Warnings of a successful compile.
+    if (!messages.empty())
+        blWarning("{}: {}", source.filename().string(), messages);
+
+    return true;
+}
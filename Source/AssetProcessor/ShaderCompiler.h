@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mutex>
+
+#include "AssetProcessor.h"
+
+// Compiles GLSL to SPIR-V inside the asset processor using shaderc when it was found
+// with the Vulkan SDK (BLUEMETAL_SHADERC), otherwise each shader runs glslc.
+//
+// The compiler is shared by every bake job. Included files are kept in an include cache,
+// so shaders sharing headers don't read them again. An entry is only used while the file
+// still has the size and modified time it was read with, --watch edits are picked up.
+class ShaderCompiler
+{
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+
+    bool IsInProcess() const; /** @brief Returns false when shaders are compiled by running glslc. */
+    const std::string& GetBackend() const; /** @brief shaderc or glslc and its version, part of every shader's bake cache key. */
+
+    /// @brief Compiles a GLSL shader and writes the SPIR-V binary. Thread safe.
+    /// @param source The GLSL source file, its extension decides the stage.
+    /// @param output Where the SPIR-V binary is written.
+    /// @param errors Compiler output when compilation fails.
+    bool Compile(const std::filesystem::path& source, const std::filesystem::path& output, std::string& errors);
+
+    /// @brief Returns the contents of an included file, reading it again only when it changed. Thread safe.
+    std::shared_ptr<const std::string> ReadInclude(const std::filesystem::path& path);
+
+    /// @brief Drops files from the include cache, for changes a size and time check could miss. Thread safe.
+    void Forget(const std::vector<std::filesystem::path>& paths);
+
+private:
+    struct Source
+    {
+        uintmax_t size = 0;
+        std::filesystem::file_time_type time;
+        std::shared_ptr<const std::string> content;
+    };
+
+    bool CompileExternal(const std::filesystem::path& source, const std::filesystem::path& output, std::string& errors);
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, Source> _sources; /** @brief Canonical path -> included file as it was read. */
+    std::string _backend;
+    void* _compiler; /** @brief The shaderc compiler when in process, kept opaque so shaderc stays out of this header. */
+};
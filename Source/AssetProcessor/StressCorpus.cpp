@@ -0,0 +1,181 @@
+#include <fstream>
+
+#include "qoixx.hpp"
+
+#include "Core/Print.h"
+#include "Core/ThreadPool.h"
+#include "StressCorpus.h"
+
+static constexpr uint32_t TextureSize = 2048;
+static constexpr uint32_t GridSize = 512;
+
+// Integer hashing keeps the noise the same on every platform and standard library,
+// std::uniform_real_distribution isn't specified bit for bit.
+static uint32_t Hash(uint32_t x, uint32_t y, uint32_t seed)
+{
+    uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return h;
+}
+
+static float ValueNoise(float x, float y, uint32_t seed)
+{
+    uint32_t x0 = (uint32_t)x, y0 = (uint32_t)y;
+    float fx = x - (float)x0, fy = y - (float)y0;
+
+    // Smoothstep between the four corners.
+    fx = fx * fx * (3.0f - 2.0f * fx);
+    fy = fy * fy * (3.0f - 2.0f * fy);
+
+    auto corner = [&](uint32_t cx, uint32_t cy){ return (float)(Hash(cx, cy, seed) & 0xffff) / 65535.0f; };
+    float top = corner(x0, y0) + (corner(x0 + 1, y0) - corner(x0, y0)) * fx;
+    float bottom = corner(x0, y0 + 1) + (corner(x0 + 1, y0 + 1) - corner(x0, y0 + 1)) * fx;
+    return top + (bottom - top) * fy;
+}
+
+// Octaves of value noise from a coarse base frequency, in [0, 1].
+static float Fractal(float x, float y, uint32_t seed, int octaves)
+{
+    float sum = 0.0f, amplitude = 0.5f, total = 0.0f;
+    for (int i = 0; i < octaves; i++)
+    {
+        sum += ValueNoise(x, y, seed + (uint32_t)i) * amplitude;
+        total += amplitude;
+        amplitude *= 0.5f;
+        x *= 2.0f;
+        y *= 2.0f;
+    }
+
+    return sum / total;
+}
+
+static bool WriteStressTexture(const std::filesystem::path& path, uint32_t seed)
+{
+    std::vector<uint8_t> pixels((size_t)TextureSize * TextureSize * 4);
+    float scale = 8.0f / (float)TextureSize;
+
+    for (uint32_t y = 0; y < TextureSize; y++)
+    {
+        for (uint32_t x = 0; x < TextureSize; x++)
+        {
+            uint8_t* pixel = &pixels[((size_t)y * TextureSize + x) * 4];
+            for (uint32_t c = 0; c < 4; c++)
+                pixel[c] = (uint8_t)(Fractal((float)x * scale, (float)y * scale, seed * 32 + c * 8, 6) * 255.0f + 0.5f);
+        }
+    }
+
+    qoixx::qoi::desc desc{TextureSize, TextureSize, 4, qoixx::qoi::colorspace::srgb};
+    auto encoded = qoixx::qoi::encode<std::vector<uint8_t>>(pixels.data(), pixels.size(), desc);
+
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(encoded.data()), (std::streamsize)encoded.size());
+    return (bool)out;
+}
+
+static bool WriteStressMesh(const std::filesystem::path& path, uint32_t seed)
+{
+    // A heightfield over [-1, 1], normals come from the height differences.
+    float scale = 4.0f / (float)GridSize;
+    auto height = [&](uint32_t x, uint32_t y){ return Fractal((float)x * scale, (float)y * scale, seed, 5) * 0.5f; };
+    float step = 2.0f / (float)(GridSize - 1);
+
+    std::string text;
+    text.reserve((size_t)GridSize * GridSize * 96);
+
+    for (uint32_t y = 0; y < GridSize; y++)
+    {
+        for (uint32_t x = 0; x < GridSize; x++)
+        {
+            float dx = height(std::min(x + 1, GridSize - 1), y) - height(x > 0 ? x - 1 : 0, y);
+            float dy = height(x, std::min(y + 1, GridSize - 1)) - height(x, y > 0 ? y - 1 : 0);
+            float length = std::sqrt(dx * dx + dy * dy + 4.0f * step * step);
+
+            text += fmt::format("v {:.5f} {:.5f} {:.5f}\n", (float)x * step - 1.0f, height(x, y), (float)y * step - 1.0f);
+            text += fmt::format("vn {:.5f} {:.5f} {:.5f}\n", -dx / length, 2.0f * step / length, -dy / length);
+            text += fmt::format("vt {:.5f} {:.5f}\n", (float)x / (float)(GridSize - 1), (float)y / (float)(GridSize - 1));
+        }
+    }
+
+    // OBJ indices start at one, each face corner shares its index for position, uv and normal.
+    for (uint32_t y = 0; y + 1 < GridSize; y++)
+    {
+        for (uint32_t x = 0; x + 1 < GridSize; x++)
+        {
+            uint32_t a = y * GridSize + x + 1, b = a + 1, c = a + GridSize, d = c + 1;
+            text += fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", a, c, b);
+            text += fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", b, c, d);
+        }
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << text;
+    return (bool)out;
+}
+
+bool GenerateStressCorpus(const std::filesystem::path& directory, uint32_t count)
+{
+    // Cycled through, a count of six or more covers every combination.
+    static const nlohmann::json textureProperties[] = {
+        {{"compression", "BC7"}},
+        {{"compression", "BC5"}, {"colorSpace", "Linear"}},
+        {{"compression", "BC1"}},
+        {{"compression", "Lossless"}},
+        {{"compression", "BC4"}, {"colorSpace", "Linear"}},
+        {{"compression", "None"}, {"mipmaps", false}},
+    };
+
+    static const nlohmann::json meshProperties[] = {
+        {{"meshlets", true}},
+        {{"vertexFormat", "Compact"}, {"splitMeshes", true}},
+        {{"lodCount", 6}, {"meshlets", true}, {"vertexFormat", "Compact"}},
+        {{"optimize", false}, {"lodCount", 1}},
+    };
+
+    std::filesystem::create_directories(directory / "Textures");
+    std::filesystem::create_directories(directory / "Models");
+
+    nlohmann::json manifest;
+    manifest["resources"] = nlohmann::json::array();
+
+    bl::ThreadPool pool;
+    std::vector<std::future<bool>> results;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto texture = fmt::format("Textures/Stress{:03}.qoi", i);
+        auto mesh = fmt::format("Models/Stress{:03}.obj", i);
+
+        auto textureObject = textureProperties[i % std::size(textureProperties)];
+        textureObject["path"] = texture;
+        textureObject["type"] = "Texture";
+        manifest["resources"].push_back(textureObject);
+
+        auto meshObject = meshProperties[i % std::size(meshProperties)];
+        meshObject["path"] = mesh;
+        meshObject["type"] = "Model";
+        manifest["resources"].push_back(meshObject);
+
+        results.push_back(pool.Submit([path = directory / texture, i](){ return WriteStressTexture(path, i); }));
+        results.push_back(pool.Submit([path = directory / mesh, i](){ return WriteStressMesh(path, i); }));
+    }
+
+    bool status = true;
+    for (auto& result : results)
+        status &= result.get();
+
+    if (!status)
+    {
+        blError("Could not write the stress corpus into {}.", directory.string());
+        return false;
+    }
+
+    std::ofstream out(directory / "Manifest.json", std::ios::out | std::ios::trunc);
+    out << manifest.dump(4);
+
+    blInfo("Wrote a stress corpus of {} textures and {} meshes into {}.", count, count, directory.string());
+    return (bool)out;
+}
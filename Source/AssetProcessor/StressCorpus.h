@@ -0,0 +1,12 @@
+#pragma once
+
+#include "AssetProcessor.h"
+
+// Writes a synthetic corpus of large textures and meshes with a manifest listing them,
+// for benchmarking bake throughput without any project assets. The corpus only depends
+// on the count, every run writes the same bytes so reports from different runs compare.
+//
+// Textures are 2048x2048 fractal noise saved as QOI, meshes are 512x512 vertex terrain
+// grids saved as OBJ. Each is listed with a different mix of bake properties so every
+// encoder and optimization path gets exercised.
+bool GenerateStressCorpus(const std::filesystem::path& directory, uint32_t count);
@@ -0,0 +1,433 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "qoixx.hpp"
+
+#include "Core/ThreadPool.h"
+#include "TextureProcessor.h"
+
+// Straightforward block encoders. Endpoints come from the principal axis of the block's
+// colors and every texel then takes the nearest palette entry. BC7 only uses mode 6, a
+// single RGBA subset with 4 bit indices, which handles most color content well.
+
+using Block = std::array<std::array<uint8_t, 4>, 16>; // 4x4 texels, RGBA, row major.
+
+static constexpr int Bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// Levels smaller than this many blocks are encoded on the calling thread.
+static constexpr size_t MinParallelBlocks = 256;
+
+// Rows per lossless stripe, enough stripes for every core on large textures while each
+// stripe stays large enough that its QOI header and end marker don't matter.
+static constexpr uint32_t LosslessStripeRows = 64;
+
+// Separate from the pool baking resources, encode jobs never wait on anything so
+// sharing threads with jobs that wait on them can't deadlock.
+static bl::ThreadPool& GetEncoderPool()
+{
+    static bl::ThreadPool pool;
+    return pool;
+}
+
+static Block FetchBlock(const BakedTextureLevel& level, uint32_t blockX, uint32_t blockY)
+{
+    // Blocks hanging over the edge repeat the last row or column, those texels are never sampled.
+    Block block;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        uint32_t x = std::min(blockX * 4 + i % 4, level.width - 1);
+        uint32_t y = std::min(blockY * 4 + i / 4, level.height - 1);
+        std::memcpy(block[i].data(), &level.pixels[((size_t)y * level.width + x) * 4], 4);
+    }
+
+    return block;
+}
+
+// Fits a line through the first N channels of the block's texels, low and high are where
+// the texels' projections onto it start and end.
+template<size_t N>
+static void FindEndpoints(const Block& block, std::array<float, N>& low, std::array<float, N>& high)
+{
+    std::array<float, N> mean{};
+    for (const auto& texel : block)
+        for (size_t c = 0; c < N; c++)
+            mean[c] += texel[c] / 16.0f;
+
+    float covariance[N][N] = {};
+    for (const auto& texel : block)
+        for (size_t a = 0; a < N; a++)
+            for (size_t b = 0; b < N; b++)
+                covariance[a][b] += (texel[a] - mean[a]) * (texel[b] - mean[b]);
+
+    // Power iteration from the row of the channel that varies most.
+    size_t largest = 0;
+    for (size_t c = 1; c < N; c++)
+        if (covariance[c][c] > covariance[largest][largest])
+            largest = c;
+
+    std::array<float, N> axis;
+    for (size_t c = 0; c < N; c++)
+        axis[c] = covariance[largest][c];
+
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        std::array<float, N> next{};
+        float scale = 0.0f;
+        for (size_t a = 0; a < N; a++)
+        {
+            for (size_t b = 0; b < N; b++)
+                next[a] += covariance[a][b] * axis[b];
+            scale = std::max(scale, std::abs(next[a]));
+        }
+
+        if (scale == 0.0f)
+            break;
+
+        for (size_t c = 0; c < N; c++)
+            axis[c] = next[c] / scale;
+    }
+
+    float length = 0.0f;
+    for (size_t c = 0; c < N; c++)
+        length += axis[c] * axis[c];
+
+    // A solid block has no axis, both endpoints are its color.
+    if (length == 0.0f)
+    {
+        low = high = mean;
+        return;
+    }
+
+    float minT = 0.0f, maxT = 0.0f;
+    for (const auto& texel : block)
+    {
+        float t = 0.0f;
+        for (size_t c = 0; c < N; c++)
+            t += (texel[c] - mean[c]) * axis[c];
+
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    for (size_t c = 0; c < N; c++)
+    {
+        low[c] = std::clamp(mean[c] + axis[c] * minT / length, 0.0f, 255.0f);
+        high[c] = std::clamp(mean[c] + axis[c] * maxT / length, 0.0f, 255.0f);
+    }
+}
+
+template<size_t N>
+static uint32_t FindNearest(const std::array<uint8_t, 4>& texel, const std::array<float, N>* palette, uint32_t count)
+{
+    uint32_t best = 0;
+    float bestError = std::numeric_limits<float>::max();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float error = 0.0f;
+        for (size_t c = 0; c < N; c++)
+            error += (texel[c] - palette[i][c]) * (texel[c] - palette[i][c]);
+
+        if (error < bestError)
+        {
+            best = i;
+            bestError = error;
+        }
+    }
+
+    return best;
+}
+
+static void WriteLittleEndian(uint8_t* out, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+        out[i] = (uint8_t)(value >> (i * 8));
+}
+
+static uint16_t ToRgb565(const std::array<float, 3>& color)
+{
+    auto r = (uint16_t)std::lround(color[0] * 31.0f / 255.0f);
+    auto g = (uint16_t)std::lround(color[1] * 63.0f / 255.0f);
+    auto b = (uint16_t)std::lround(color[2] * 31.0f / 255.0f);
+    return (uint16_t)(r << 11 | g << 5 | b);
+}
+
+static std::array<float, 3> FromRgb565(uint16_t color)
+{
+    uint32_t r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+    return {(float)(r << 3 | r >> 2), (float)(g << 2 | g >> 4), (float)(b << 3 | b >> 2)};
+}
+
+static void EncodeBC1(const Block& block, uint8_t* out)
+{
+    std::array<float, 3> low, high;
+    FindEndpoints<3>(block, low, high);
+
+    // The first endpoint being larger selects the four color mode, BC3 always uses it.
+    uint16_t color0 = ToRgb565(high), color1 = ToRgb565(low);
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    // Equal endpoints leave every index at zero, the first palette entry in either mode.
+    uint32_t indices = 0;
+    if (color0 != color1)
+    {
+        std::array<float, 3> palette[4];
+        palette[0] = FromRgb565(color0);
+        palette[1] = FromRgb565(color1);
+        for (size_t c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+
+        for (uint32_t i = 0; i < 16; i++)
+            indices |= FindNearest<3>(block[i], palette, 4) << (i * 2);
+    }
+
+    WriteLittleEndian(out, color0, 2);
+    WriteLittleEndian(out + 2, color1, 2);
+    WriteLittleEndian(out + 4, indices, 4);
+}
+
+static void EncodeBC4(const Block& block, size_t channel, uint8_t* out)
+{
+    uint8_t low = 255, high = 0;
+    for (const auto& texel : block)
+    {
+        low = std::min(low, texel[channel]);
+        high = std::max(high, texel[channel]);
+    }
+
+    // The first endpoint being larger selects eight values evenly spaced between the two.
+    uint64_t indices = 0;
+    if (high > low)
+    {
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            // Sevenths of the way from high to low, the endpoints themselves are indices 0 and 1.
+            auto step = std::lround((high - block[i][channel]) * 7.0f / (high - low));
+            uint64_t index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+            indices |= index << (i * 3);
+        }
+    }
+
+    out[0] = high;
+    out[1] = low;
+    WriteLittleEndian(out + 2, indices, 6);
+}
+
+// Quantizes an endpoint to 7 bits per channel plus the p-bit all four channels share,
+// trying both p-bits and keeping the closer result.
+static void QuantizeBc7Endpoint(const std::array<float, 4>& color, std::array<uint8_t, 4>& quantized, uint32_t& pbit)
+{
+    float bestError = std::numeric_limits<float>::max();
+    for (uint32_t p = 0; p < 2; p++)
+    {
+        std::array<uint8_t, 4> candidate;
+        float error = 0.0f;
+        for (size_t c = 0; c < 4; c++)
+        {
+            candidate[c] = (uint8_t)std::clamp((int)std::lround((color[c] - (float)p) / 2.0f), 0, 127);
+            float value = (float)(candidate[c] << 1 | p);
+            error += (value - color[c]) * (value - color[c]);
+        }
+
+        if (error < bestError)
+        {
+            quantized = candidate;
+            pbit = p;
+            bestError = error;
+        }
+    }
+}
+
+static void EncodeBC7(const Block& block, uint8_t* out)
+{
+    std::array<float, 4> low, high;
+    FindEndpoints<4>(block, low, high);
+
+    std::array<uint8_t, 4> endpoints[2];
+    uint32_t pbits[2];
+    QuantizeBc7Endpoint(low, endpoints[0], pbits[0]);
+    QuantizeBc7Endpoint(high, endpoints[1], pbits[1]);
+
+    std::array<float, 4> palette[16];
+    for (size_t i = 0; i < 16; i++)
+    {
+        for (size_t c = 0; c < 4; c++)
+        {
+            int e0 = endpoints[0][c] << 1 | pbits[0];
+            int e1 = endpoints[1][c] << 1 | pbits[1];
+            palette[i][c] = (float)(((64 - Bc7Weights[i]) * e0 + Bc7Weights[i] * e1 + 32) >> 6);
+        }
+    }
+
+    uint32_t indices[16];
+    for (uint32_t i = 0; i < 16; i++)
+        indices[i] = FindNearest<4>(block[i], palette, 16);
+
+    // The first texel's index is stored without its top bit, swapping the endpoints
+    // mirrors every index and clears it. The weights are symmetric so nothing else changes.
+    if (indices[0] >= 8)
+    {
+        std::swap(endpoints[0], endpoints[1]);
+        std::swap(pbits[0], pbits[1]);
+        for (auto& index : indices)
+            index = 15 - index;
+    }
+
+    std::memset(out, 0, 16);
+    uint32_t position = 0;
+    auto write = [&](uint32_t value, uint32_t bits){
+        for (uint32_t i = 0; i < bits; i++, position++)
+            out[position / 8] |= (uint8_t)((value >> i & 1) << position % 8);
+    };
+
+    write(1 << 6, 7); // Mode 6, six zero bits and a one.
+    for (size_t c = 0; c < 4; c++)
+    {
+        write(endpoints[0][c], 7);
+        write(endpoints[1][c], 7);
+    }
+
+    write(pbits[0], 1);
+    write(pbits[1], 1);
+
+    for (uint32_t i = 0; i < 16; i++)
+        write(indices[i], i == 0 ? 3 : 4);
+}
+
+static void EncodeBlock(const Block& block, TextureCompression compression, uint8_t* out)
+{
+    switch (compression)
+    {
+    case TextureCompression::eBC1:
+        EncodeBC1(block, out);
+        break;
+    case TextureCompression::eBC3:
+        EncodeBC4(block, 3, out);
+        EncodeBC1(block, out + 8);
+        break;
+    case TextureCompression::eBC4:
+        EncodeBC4(block, 0, out);
+        break;
+    case TextureCompression::eBC5:
+        EncodeBC4(block, 0, out);
+        EncodeBC4(block, 1, out + 8);
+        break;
+    case TextureCompression::eBC7:
+        EncodeBC7(block, out);
+        break;
+    default:
+        break;
+    }
+}
+
+static BakedTextureLevel CompressLevel(const BakedTextureLevel& level, TextureCompression compression, uint32_t blockSize)
+{
+    uint32_t blocksX = (level.width + 3) / 4;
+    uint32_t blocksY = (level.height + 3) / 4;
+    BakedTextureLevel compressed{level.width, level.height, std::vector<uint8_t>((size_t)blocksX * blocksY * blockSize)};
+
+    auto encodeRow = [&](uint32_t blockY){
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+            EncodeBlock(FetchBlock(level, blockX, blockY), compression, &compressed.pixels[((size_t)blockY * blocksX + blockX) * blockSize]);
+    };
+
+    if ((size_t)blocksX * blocksY < MinParallelBlocks)
+    {
+        for (uint32_t blockY = 0; blockY < blocksY; blockY++)
+            encodeRow(blockY);
+
+        return compressed;
+    }
+
+    // Every row of blocks writes its own part of the output, so rows are independent jobs.
+    std::vector<std::future<void>> jobs;
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++)
+        jobs.push_back(GetEncoderPool().Submit([&encodeRow, blockY](){ encodeRow(blockY); }));
+
+    // Every job has to be done with the output before an error leaves this function.
+    for (auto& job : jobs)
+        job.wait();
+
+    for (auto& job : jobs)
+        job.get();
+
+    return compressed;
+}
+
+// Codes a level as a TextureStripe table followed by one QOI image per stripe.
+static BakedTextureLevel EncodeStripes(const BakedTextureLevel& level, uint32_t stripeRows, bool srgb)
+{
+    uint32_t stripeCount = (level.height + stripeRows - 1) / stripeRows;
+    size_t rowSize = (size_t)level.width * 4;
+
+    auto encodeStripe = [&](uint32_t stripe){
+        uint32_t firstRow = stripe * stripeRows;
+
+        qoixx::qoi::desc desc;
+        desc.width = level.width;
+        desc.height = std::min(stripeRows, level.height - firstRow);
+        desc.channels = 4;
+        desc.colorspace = srgb ? qoixx::qoi::colorspace::srgb : qoixx::qoi::colorspace::linear;
+
+        return qoixx::qoi::encode<std::vector<uint8_t>, uint8_t>(&level.pixels[firstRow * rowSize], desc.height * rowSize, desc);
+    };
+
+    std::vector<std::future<std::vector<uint8_t>>> jobs;
+    for (uint32_t stripe = 0; stripe < stripeCount; stripe++)
+        jobs.push_back(GetEncoderPool().Submit([&encodeStripe, stripe](){ return encodeStripe(stripe); }));
+
+    // Every job has to be done with the level before an error leaves this function.
+    for (auto& job : jobs)
+        job.wait();
+
+    BakedTextureLevel coded{level.width, level.height, std::vector<uint8_t>(stripeCount * sizeof(bl::TextureStripe))};
+    for (uint32_t stripe = 0; stripe < stripeCount; stripe++)
+    {
+        auto data = jobs[stripe].get();
+
+        bl::TextureStripe entry{coded.pixels.size(), data.size()};
+        std::memcpy(&coded.pixels[stripe * sizeof(bl::TextureStripe)], &entry, sizeof(entry));
+        coded.pixels.insert(coded.pixels.end(), data.begin(), data.end());
+    }
+
+    return coded;
+}
+
+void CompressTexture(BakedTexture& texture, TextureCompression compression)
+{
+    bool srgb = texture.pixelFormat == bl::TexturePixelFormat::eRGBA8Srgb;
+
+    switch (compression)
+    {
+    case TextureCompression::eNone:
+        return;
+    case TextureCompression::eLossless:
+        texture.stripeRows = LosslessStripeRows;
+        for (auto& level : texture.levels)
+            level = EncodeStripes(level, texture.stripeRows, srgb);
+        return;
+    case TextureCompression::eBC1:
+        texture.pixelFormat = srgb ? bl::TexturePixelFormat::eBC1Srgb : bl::TexturePixelFormat::eBC1Unorm;
+        break;
+    case TextureCompression::eBC3:
+        texture.pixelFormat = srgb ? bl::TexturePixelFormat::eBC3Srgb : bl::TexturePixelFormat::eBC3Unorm;
+        break;
+    case TextureCompression::eBC4:
+        texture.pixelFormat = bl::TexturePixelFormat::eBC4Unorm;
+        break;
+    case TextureCompression::eBC5:
+        texture.pixelFormat = bl::TexturePixelFormat::eBC5Unorm;
+        break;
+    case TextureCompression::eBC7:
+        texture.pixelFormat = srgb ? bl::TexturePixelFormat::eBC7Srgb : bl::TexturePixelFormat::eBC7Unorm;
+        break;
+    }
+
+    uint32_t blockSize = bl::GetTextureBlockSize(texture.pixelFormat);
+    for (auto& level : texture.levels)
+        level = CompressLevel(level, compression, blockSize);
+}
@@ -0,0 +1,185 @@
+#include <cstring>
+#include <fstream>
+
+#include "qoixx.hpp"
+
+#include "Core/Print.h"
+#include "Graphics/stb_image.h"
+#include "BakeReport.h"
+#include "TextureProcessor.h"
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool ImportTexture(const ResourceFile& resource, BakedTexture& texture)
+{
+    auto extension = resource.absolutePath.extension();
+    if (extension != ".qoi" && extension != ".png" && extension != ".jpg" && extension != ".jpeg")
+    {
+        blError("{}: Invalid texture file type, please convert it manually.", resource.relativePath);
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    {
+        BakeStageTimer timer{BakeStage::eRead};
+        std::ifstream file(resource.absolutePath, std::ios::in | std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    BakeStageTimer timer{BakeStage::eImport};
+    BakedTextureLevel level{};
+
+    if (extension == ".qoi")
+    {
+        try
+        {
+            auto [pixels, desc] = qoixx::qoi::decode<std::vector<uint8_t>>(data.data(), data.size(), 4);
+            level = {desc.width, desc.height, std::move(pixels)};
+        }
+        catch (const std::exception& e)
+        {
+            blError("{}: Could not load this texture, {}", resource.relativePath, e.what());
+            return false;
+        }
+    }
+    else
+    {
+        int x = 0, y = 0, channels = 0;
+        auto pixels = stbi_load_from_memory(data.data(), (int)data.size(), &x, &y, &channels, 4);
+
+        if (pixels == nullptr)
+        {
+            blError("{}: Could not load this texture.", resource.relativePath);
+            return false;
+        }
+
+        level = {(uint32_t)x, (uint32_t)y, std::vector<uint8_t>(pixels, pixels + (size_t)x * y * 4)};
+        stbi_image_free(pixels);
+    }
+
+    texture.levels.clear();
+    texture.levels.push_back(std::move(level));
+    return true;
+}
+
+bool WriteTexture(const BakedTexture& texture, const std::filesystem::path& path)
+{
+    std::vector<bl::TextureLevel> levels(texture.levels.size());
+
+    uint64_t offset = sizeof(bl::TextureHeader) + levels.size() * sizeof(bl::TextureLevel);
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        offset = AlignUp(offset, bl::TextureAlignment);
+        levels[i].offset = offset;
+        levels[i].size = texture.levels[i].pixels.size();
+        levels[i].width = texture.levels[i].width;
+        levels[i].height = texture.levels[i].height;
+        offset += levels[i].size;
+    }
+
+    bl::TextureHeader header{};
+    std::memcpy(header.magic, "BMTF", 4);
+    header.version = bl::TextureVersion;
+    header.width = texture.levels[0].width;
+    header.height = texture.levels[0].height;
+    header.levelCount = (uint32_t)levels.size();
+    header.pixelFormat = (uint32_t)texture.pixelFormat;
+    header.flags = texture.stripeRows > 0 ? bl::TextureFlagQoiStripes : 0;
+    header.stripeRows = texture.stripeRows;
+
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(levels.data()), (std::streamsize)(levels.size() * sizeof(bl::TextureLevel)));
+
+    static const char padding[bl::TextureAlignment] = {};
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        out.write(padding, (std::streamsize)(levels[i].offset - (uint64_t)out.tellp()));
+        out.write(reinterpret_cast<const char*>(texture.levels[i].pixels.data()), (std::streamsize)levels[i].size);
+    }
+
+    return (bool)out;
+}
+
+bool ProcessTexture(ProcessorState& state, ResourceFile& resource)
+{
+    auto exportedPath = (state.outputPath / resource.relativePath).replace_extension(".bmt");
+    auto exportedFilename = exportedPath.filename();
+    auto relativeExportedPath = std::filesystem::path(resource.relativePath).parent_path() / exportedFilename;
+
+    std::filesystem::create_directories(exportedPath.parent_path());
+
+    BakedTexture texture;
+    if (!ImportTexture(resource, texture))
+        return false;
+
+    // "compression": "BC7" for color, "BC5" for normal maps and "BC4" for masks. "Lossless"
+    // keeps every texel exact and is decoded in parallel stripes when the texture loads.
+    static const std::map<std::string, TextureCompression> compressions = {
+        {"None", TextureCompression::eNone},
+        {"BC1", TextureCompression::eBC1},
+        {"BC3", TextureCompression::eBC3},
+        {"BC4", TextureCompression::eBC4},
+        {"BC5", TextureCompression::eBC5},
+        {"BC7", TextureCompression::eBC7},
+        {"Lossless", TextureCompression::eLossless},
+    };
+
+    auto compressionName = resource.properties.value("compression", "None");
+    auto compression = compressions.find(compressionName);
+    if (compression == compressions.end())
+    {
+        blError("{}: Unknown compression {}, expected None, BC1, BC3, BC4, BC5, BC7 or Lossless.", resource.relativePath, compressionName);
+        return false;
+    }
+
+    bool linearOnly = compression->second == TextureCompression::eBC4 || compression->second == TextureCompression::eBC5;
+
+    // "colorSpace": "Linear" is for data like normal maps, their mips are averaged as stored.
+    auto colorSpace = resource.properties.value("colorSpace", linearOnly ? "Linear" : "sRGB");
+    if (linearOnly && colorSpace != "Linear")
+    {
+        blError("{}: {} textures are always linear, remove the color space or set it to Linear.", resource.relativePath, compressionName);
+        return false;
+    }
+
+    if (colorSpace == "Linear")
+    {
+        texture.pixelFormat = bl::TexturePixelFormat::eRGBA8Unorm;
+    }
+    else if (colorSpace != "sRGB")
+    {
+        blError("{}: Unknown color space {}, expected sRGB or Linear.", resource.relativePath, colorSpace);
+        return false;
+    }
+
+    // On unless the manifest turns it off with "mipmaps": false, for textures only ever drawn at their own size.
+    if (resource.properties.value("mipmaps", true))
+    {
+        BakeStageTimer timer{BakeStage::eOptimize};
+        GenerateMips(texture);
+    }
+
+    {
+        BakeStageTimer timer{BakeStage::eEncode};
+        CompressTexture(texture, compression->second);
+    }
+
+    BakeStageTimer timer{BakeStage::eWrite};
+    if (!WriteTexture(texture, exportedPath))
+    {
+        blError("{}: Could not write the baked texture.", resource.relativePath);
+        return false;
+    }
+
+    blVerbose("{}: Baked {}x{} with {} mip levels as {}.", resource.relativePath, texture.levels[0].width, texture.levels[0].height, texture.levels.size(), compressionName);
+
+    resource.bakedPath = relativeExportedPath;
+    return true;
+}
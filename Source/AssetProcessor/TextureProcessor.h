@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Graphics/TextureFileFormat.h"
+#include "AssetProcessor.h"
+
+// The texture being baked, decoded from its source image and written out as BMTF once
+// every processing step has run over it, see Graphics/TextureFileFormat.h.
+
+// One level of the mip chain, 8 bit RGBA.
+struct BakedTextureLevel
+{
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> pixels;
+};
+
+struct BakedTexture
+{
+    std::vector<BakedTextureLevel> levels; // Largest first, level 0 is the source image.
+    bl::TexturePixelFormat pixelFormat = bl::TexturePixelFormat::eRGBA8Srgb;
+    uint32_t stripeRows = 0; // Non zero once levels are coded as QOI stripes, a level's pixels are then its coded bytes.
+};
+
+enum class TextureCompression
+{
+    eNone,
+    eBC1, // RGB, 8:1 against RGBA8.
+    eBC3, // RGBA, 4:1.
+    eBC4, // One channel, 8:1, for masks.
+    eBC5, // Two channels, 4:1, for normal maps.
+    eBC7, // RGBA at a higher quality than BC3, 4:1, for color.
+    eLossless, // RGBA8 coded as QOI stripes, decoded in parallel at load time.
+};
+
+bool ImportTexture(const ResourceFile& resource, BakedTexture& texture);
+
+// Builds every level below level 0 down to 1x1 with a box filter, odd sizes included.
+// Colors are averaged in linear space so sRGB textures don't darken as they shrink, and
+// weighted by alpha so transparent texels don't bleed into them. See MipGenerator.cpp.
+void GenerateMips(BakedTexture& texture);
+
+// Block compresses or stripe codes every level in place, rows of blocks and stripes are
+// encoded in parallel. Levels stay in the texture's color space, BC4 and BC5 only take
+// linear data. See TextureEncoder.cpp.
+void CompressTexture(BakedTexture& texture, TextureCompression compression);
+
+bool WriteTexture(const BakedTexture& texture, const std::filesystem::path& path);
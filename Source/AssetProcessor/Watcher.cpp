@@ -0,0 +1,230 @@
+#include "Core/Hash.h"
+#include "Core/Platform.h"
+#include "Core/Print.h"
+#include "Resource/HotReload.h"
+#include "BakeCache.h"
+#include "PackWriter.h"
+#include "ShaderCompiler.h"
+#include "Watcher.h"
+
+#if defined(BLUEMETAL_SYSTEM_LINUX)
+    #include <cerrno>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+#if defined(BLUEMETAL_SYSTEM_LINUX)
+
+// Editors save in several steps, changes are gathered until none arrive for this long.
+static constexpr int SettleMilliseconds = 50;
+
+// Hash of a baked output, zero if there isn't one yet.
+static uint64_t HashOutput(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return 0;
+
+    std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    return bl::Hash64(content);
+}
+
+class Watcher
+{
+public:
+    Watcher(ProcessorState& state, const std::vector<ResourceFile*>& resources)
+        : _state(state)
+        , _resources(resources)
+        , _inotify(inotify_init1(IN_CLOEXEC))
+    {
+    }
+
+    ~Watcher()
+    {
+        if (_inotify >= 0)
+            close(_inotify);
+    }
+
+    bool Run()
+    {
+        if (_inotify < 0)
+        {
+            blError("Could not start watching the source files.");
+            return false;
+        }
+
+        Track();
+        blInfo("Watching {} directories for changes, stop with Ctrl+C.", _directories.size());
+
+        while (true)
+        {
+            std::set<ResourceFile*> changed;
+            std::vector<std::filesystem::path> files;
+            if (!WaitForChanges(changed, files))
+                return false;
+
+            Rebake(changed, files);
+        }
+    }
+
+private:
+    // Maps every file a resource reads to the resource and watches its directory. Called
+    // again after each rebake, a shader may include different files than before.
+    void Track()
+    {
+        _readers.clear();
+
+        for (auto* resource : _resources)
+        {
+            auto files = resource->dependencies;
+            files.push_back(resource->absolutePath);
+
+            for (const auto& file : files)
+            {
+                auto path = std::filesystem::weakly_canonical(file);
+                _readers[path].push_back(resource);
+
+                auto directory = path.parent_path();
+                if (_watched.contains(directory))
+                    continue;
+
+                // Saves that replace the file by renaming over it are moves, not writes.
+                int watch = inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (watch < 0)
+                {
+                    blWarning("Could not watch {}, changes in it won't be rebaked.", directory.string());
+                    continue;
+                }
+
+                _watched.insert(directory);
+                _directories[watch] = directory;
+            }
+        }
+    }
+
+    bool WaitForChanges(std::set<ResourceFile*>& changed, std::vector<std::filesystem::path>& files)
+    {
+        alignas(inotify_event) char buffer[16384];
+        pollfd descriptor{_inotify, POLLIN, 0};
+
+        // Blocks until the first change, then only waits for the rest to settle.
+        int timeout = -1;
+
+        while (true)
+        {
+            int ready = poll(&descriptor, 1, timeout);
+            if (ready < 0 && errno == EINTR)
+                continue;
+
+            if (ready < 0)
+            {
+                blError("Stopped watching, the source file watch failed.");
+                return false;
+            }
+
+            if (ready == 0)
+            {
+                if (!changed.empty())
+                    return true;
+
+                timeout = -1;
+                continue;
+            }
+
+            ssize_t size = read(_inotify, buffer, sizeof(buffer));
+            for (char* next = buffer; size > 0 && next < buffer + size;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(next);
+                next += sizeof(inotify_event) + event->len;
+
+                auto directory = _directories.find(event->wd);
+                if (directory == _directories.end() || event->len == 0)
+                    continue;
+
+                auto readers = _readers.find(directory->second / event->name);
+                if (readers != _readers.end())
+                {
+                    changed.insert(readers->second.begin(), readers->second.end());
+                    files.push_back(readers->first);
+                }
+            }
+
+            timeout = SettleMilliseconds;
+        }
+    }
+
+    void Rebake(const std::set<ResourceFile*>& changed, const std::vector<std::filesystem::path>& files)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::string> rebaked;
+
+        // The shader compiler keeps includes between bakes, it has to read the edited ones again.
+        if (_state.shaderCompiler)
+            _state.shaderCompiler->Forget(files);
+
+        // Manifest order, the same order a full bake reports in.
+        for (auto* resource : _resources)
+        {
+            if (!changed.contains(resource))
+                continue;
+
+            // An edited shader or include that compiles to the same SPIR-V as before is
+            // either a no-op edit or a stale source, either way the game won't see it.
+            bool shader = resource->type == "Shader" && !resource->bakedPath.empty();
+            uint64_t before = shader ? HashOutput(_state.outputPath / resource->bakedPath) : 0;
+
+            bool status = false;
+            try
+            {
+                status = ProcessResource(_state, *resource);
+            }
+            catch (const std::exception& e)
+            {
+                blError("{}: {}", resource->relativePath, e.what());
+            }
+
+            if (status && shader && before != 0 && HashOutput(_state.outputPath / resource->bakedPath) == before)
+                blWarning("{}: Rebaked to the same SPIR-V as before, the edit doesn't change the shader.", resource->relativePath);
+
+            if (status)
+                rebaked.push_back(GetManifestPath(*resource));
+            else
+                blError("{}: Could not be processed, the game keeps the last good bake.", resource->relativePath);
+        }
+
+        if (_state.cache)
+            _state.cache->Save();
+
+        Track();
+
+        if (rebaked.empty())
+            return;
+
+        auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (bl::HotReloadSocket::Send(_state.outputPath / bl::HotReloadSocketName, rebaked))
+            blInfo("Rebaked {} resources in {} ms, the game is reloading them.", rebaked.size(), milliseconds);
+        else
+            blInfo("Rebaked {} resources in {} ms, no game is listening.", rebaked.size(), milliseconds);
+    }
+
+    ProcessorState& _state;
+    const std::vector<ResourceFile*>& _resources;
+    int _inotify;
+    std::map<int, std::filesystem::path> _directories; // Watch descriptor to the directory it watches.
+    std::set<std::filesystem::path> _watched;
+    std::map<std::filesystem::path, std::vector<ResourceFile*>> _readers; // Source file to every resource that reads it.
+};
+
+#endif
+
+bool WatchResources(ProcessorState& state, const std::vector<ResourceFile*>& resources)
+{
+#if defined(BLUEMETAL_SYSTEM_LINUX)
+    Watcher watcher{state, resources};
+    return watcher.Run();
+#else
+    blError("Watching for changes needs inotify, it's only supported on Linux.");
+    return false;
+#endif
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "AssetProcessor.h"
+
+// Watches the source files of every resource, shader includes too, and rebakes the
+// resources whose files change. The engine manifest paths of everything rebaked are
+// then sent to a running game over its hot reload socket, see Resource/HotReload.h.
+//
+// Rebaked files are only written loose, the pack isn't rewritten. The game reads a
+// reloaded resource from its loose file from then on. Resources added to the manifest
+// while watching need a normal bake. Runs until the process is stopped, only on Linux.
+bool WatchResources(ProcessorState& state, const std::vector<ResourceFile*>& resources);
@@ -7,7 +7,20 @@ namespace bl
 Sound::Sound(ResourceManager* manager, const nlohmann::json& json, AudioSystem* system)
     : Resource(manager, json)
     , _system(system)
+    , _loadMode(SoundLoadMode::eDecompress)
+    , _sound(nullptr)
+    , _subSound(nullptr)
+    , _decodedSize(0)
 {
+    // Written by the asset processor, sounds that were never baked decode up front like FMOD_DEFAULT.
+    auto loadMode = json.value("LoadMode", "Decompress");
+
+    if (loadMode == "Compressed")
+        _loadMode = SoundLoadMode::eCompressed;
+    else if (loadMode == "Stream")
+        _loadMode = SoundLoadMode::eStream;
+    else if (loadMode != "Decompress")
+        throw std::runtime_error("Unknown sound load mode: " + loadMode);
 }
 
 Sound::~Sound() 
@@ -18,18 +31,85 @@ Sound::~Sound()
 
 void Sound::Load()
 {
-    FMOD_CHECK(_system->Get()->createSound(GetPath().string().c_str(), FMOD_DEFAULT | FMOD_3D, nullptr, &_sound))
+    LoadData();
+    FinishLoad();
+}
+
+void Sound::LoadData()
+{
+    auto data = ReadData();
+    auto buffer = data.GetSpan();
+
+    FMOD_CREATESOUNDEXINFO info{};
+    info.cbsize = sizeof(info);
+    info.length = (unsigned int)buffer.size();
+
+    // Decompressed sounds are decoded into FMOD's own memory, the file can go once they are.
+    // Everything else points FMOD at the mapped file and keeps it until unloaded.
+    FMOD_MODE mode = FMOD_3D;
+    switch (_loadMode)
+    {
+    case SoundLoadMode::eDecompress:
+        mode |= FMOD_OPENMEMORY | FMOD_CREATESAMPLE;
+        break;
+    case SoundLoadMode::eCompressed:
+        mode |= FMOD_OPENMEMORY_POINT | FMOD_CREATECOMPRESSEDSAMPLE;
+        break;
+    case SoundLoadMode::eStream:
+        mode |= FMOD_OPENMEMORY_POINT | FMOD_CREATESTREAM;
+        break;
+    }
+
+    FMOD_CHECK(_system->Get()->createSound(reinterpret_cast<const char*>(buffer.data()), mode, &info, &_sound))
+
+    int numSubSounds = 0;
+    FMOD_CHECK(_sound->getNumSubSounds(&numSubSounds))
+
+    if (numSubSounds > 0)
+        FMOD_CHECK(_sound->getSubSound(0, &_subSound))
+
+    if (_loadMode != SoundLoadMode::eDecompress)
+    {
+        _data = std::move(data);
+    }
+    else
+    {
+        unsigned int length = 0;
+        FMOD_CHECK(Get()->getLength(&length, FMOD_TIMEUNIT_PCMBYTES))
+        _decodedSize = length;
+    }
+}
+
+void Sound::FinishLoad()
+{
+    Resource::Load();
 }
 
 void Sound::Unload()
 {
-    FMOD_CHECK(_sound->release())
+    if (_sound)
+        FMOD_CHECK(_sound->release())
+
     _sound = nullptr;
+    _subSound = nullptr;
+    _data = {};
+    _decodedSize = 0;
+    Resource::Unload();
+}
+
+ResourceMemory Sound::GetMemoryUsage() const
+{
+    return ResourceMemory{_data.GetSize() + _decodedSize, 0};
+}
+
+SoundLoadMode Sound::GetLoadMode() const
+{
+    return _loadMode;
 }
 
 FMOD::Sound* Sound::Get() 
 { 
-    return _sound; 
+    return _subSound ? _subSound : _sound; 
 }
 
 } // namespace bl
\ No newline at end of file
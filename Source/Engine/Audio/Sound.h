@@ -9,6 +9,14 @@ namespace bl
 
 class AudioSystem;
 
+/** @brief How a sound is held in memory, picked per sound by the asset processor and recorded in the manifest. */
+enum class SoundLoadMode
+{
+    eDecompress, /** @brief Decoded to PCM when loaded, for short sounds played often. */
+    eCompressed, /** @brief Kept compressed in memory and decoded as each voice plays. */
+    eStream, /** @brief Decoded a little at a time while playing, the file is paged in as it's read. */
+};
+
 class Sound : public Resource
 {
 public:
@@ -17,12 +25,20 @@ public:
 
     virtual void Load(); /** @brief From Resource, loads the sound file into memory. */
     virtual void Unload(); /** @brief From Resource, frees the sound file from memory. */
+    virtual void LoadData(); /** @brief From Resource, creates the sound, FMOD allows it from any thread. */
+    virtual void FinishLoad();
+    virtual ResourceMemory GetMemoryUsage() const; /** @brief From Resource, the decoded samples or the file they're played out of. */
 
+    SoundLoadMode GetLoadMode() const;
     FMOD::Sound* Get();
 
 private:
     AudioSystem* _system;
+    SoundLoadMode _loadMode;
+    ResourceData _data; /** @brief Compressed and streamed sounds play straight out of the file, it stays mapped while loaded. */
     FMOD::Sound* _sound;
+    FMOD::Sound* _subSound; /** @brief Baked sounds are an FSB bank holding one sound, this is it. */
+    std::size_t _decodedSize; /** @brief PCM bytes FMOD holds for a decompressed sound. */
 };
 
 } // namespace bl
\ No newline at end of file
@@ -13,16 +13,17 @@ struct AutoCTTI
 {
 };
 
-using CTTI = size_t; 
+using CTTIIdentity = size_t; 
 
 consteval uint32_t Hash32_CT(const char* string, size_t n, uint32_t basis = uint_least32_t(2166136261))
 {
     return n == 0 ? basis : Hash32_CT(string + 1, n - 1, (basis ^ string[0]) * uint_least32_t(16777619));
 }
 
-consteval uint32_t Hash64_CT(const char* string, size_t n, uint32_t basis = uint_least64_t(14695981039346656037U))
+// Bytes are hashed unsigned, so it's the same as bl::Hash64 and can look up what the asset processor hashed.
+consteval uint64_t Hash64_CT(const char* string, size_t n, uint64_t basis = uint64_t(14695981039346656037ull))
 {
-    return n == 0 ? basis : Hash32_CT(string + 1, n - 1, (basis ^ string[0]) * uint_least64_t(1099511628211));
+    return n == 0 ? basis : Hash64_CT(string + 1, n - 1, (basis ^ (uint8_t)string[0]) * uint64_t(1099511628211ull));
 }
 
 template<size_t N>
@@ -42,9 +43,9 @@ consteval uint32_t Hash32_CT(const std::string_view& view)
     return Hash32_CT(view.data(), view.size() - 1);
 }
 
-consteval uint32_t Hash64_CT(const std::string_view& view)
+consteval uint64_t Hash64_CT(const std::string_view& view)
 {
-    return Hash64_CT(view.data(), view.size() - 1);
+    return Hash64_CT(view.data(), view.size());
 }
 
 template<typename T>
@@ -92,7 +93,7 @@ consteval std::string_view type_name_impl()
 template<typename T>
 static constexpr bool fundamental_specialized = std::is_fundamental<T>::value && !std::is_same<T, void>::value;
 
-template<typename T, std::enable_if_t<fundamental_specialized<T>, bool> == false>
+template<typename T, std::enable_if_t<fundamental_specialized<T>, bool> = false>
 consteval std::string_view type_name()
 {
     return type_name_impl<T>();
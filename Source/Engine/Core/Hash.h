@@ -7,6 +7,26 @@ namespace bl
 
 #define BL_HASH_DEFAULT_SEED 0x59CFA54A2CD1
 
+#define BL_HASH64_FNV_BASIS 14695981039346656037ull
+#define BL_HASH64_FNV_PRIME 1099511628211ull
+
+/// @brief 64-bit FNV-1a, stable across platforms and runs so it's safe to write into baked files.
+/// @param basis Pass a previous result to continue hashing a stream in pieces.
+constexpr uint64_t Hash64(std::string_view string, uint64_t basis = BL_HASH64_FNV_BASIS)
+{
+    for (char c : string)
+        basis = (basis ^ (uint8_t)c) * BL_HASH64_FNV_PRIME;
+    return basis;
+}
+
+/// @brief 64-bit FNV-1a over raw bytes, matches Hash64 for the same bytes as a string.
+inline uint64_t Hash64(std::span<const std::byte> data, uint64_t basis = BL_HASH64_FNV_BASIS)
+{
+    for (std::byte b : data)
+        basis = (basis ^ (uint8_t)b) * BL_HASH64_FNV_PRIME;
+    return basis;
+}
+
 // Primary template for hash_combine function
 template <typename T>
 void hash_combine(std::size_t& seed, const T& value) {
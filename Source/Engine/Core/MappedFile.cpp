@@ -0,0 +1,154 @@
+#include "Core/Platform.h"
+#include "MappedFile.h"
+
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace bl
+{
+
+MappedFile::MappedFile()
+    : _data(nullptr)
+    , _size(0)
+    , _handle(nullptr)
+{
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+    : _path(path)
+    , _data(nullptr)
+    , _size(0)
+    , _handle(nullptr)
+{
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Could not open a file to map: " + path.string());
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    _size = (size_t)size.QuadPart;
+
+    // Zero sized files can't be mapped, they're just empty.
+    if (_size > 0)
+    {
+        _handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_handle)
+            _data = static_cast<const std::byte*>(MapViewOfFile(_handle, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    CloseHandle(file);
+
+    if (_size > 0 && !_data)
+    {
+        Unmap();
+        throw std::runtime_error("Could not map a file: " + path.string());
+    }
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        throw std::runtime_error("Could not open a file to map: " + path.string());
+
+    struct stat info{};
+    fstat(file, &info);
+    _size = (size_t)info.st_size;
+
+    // Zero sized files can't be mapped, they're just empty.
+    if (_size > 0)
+    {
+        void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+        _data = mapped == MAP_FAILED ? nullptr : static_cast<const std::byte*>(mapped);
+    }
+
+    // The mapping holds its own reference to the file.
+    close(file);
+
+    if (_size > 0 && !_data)
+        throw std::runtime_error("Could not map a file: " + path.string());
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& rhs)
+    : _data(nullptr)
+    , _size(0)
+    , _handle(nullptr)
+{
+    this->operator=(std::move(rhs));
+}
+
+MappedFile::~MappedFile()
+{
+    Unmap();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs)
+{
+    Unmap();
+
+    _path = std::move(rhs._path);
+    _data = rhs._data;
+    _size = rhs._size;
+    _handle = rhs._handle;
+
+    rhs._data = nullptr;
+    rhs._size = 0;
+    rhs._handle = nullptr;
+
+    return *this;
+}
+
+std::span<const std::byte> MappedFile::GetData() const
+{
+    return {_data, _size};
+}
+
+const std::filesystem::path& MappedFile::GetPath() const
+{
+    return _path;
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const
+{
+    if (!_data || offset >= _size)
+        return;
+
+    size = std::min(size, _size - offset);
+
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<std::byte*>(_data + offset), size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // The range has to start on a page boundary.
+    static const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = offset / pageSize * pageSize;
+    madvise(const_cast<std::byte*>(_data + start), size + (offset - start), MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::Unmap()
+{
+#if defined(BLUEMETAL_SYSTEM_WINDOWS)
+    if (_data)
+        UnmapViewOfFile(_data);
+
+    if (_handle)
+        CloseHandle(_handle);
+#else
+    if (_data)
+        munmap(const_cast<std::byte*>(_data), _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+    _handle = nullptr;
+}
+
+} // namespace bl
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+
+namespace bl
+{
+
+/// @brief A read only view of a whole file mapped into memory.
+///
+/// Pages are only read from disk when they're first touched, so mapping a large
+/// file and reading a small part of it only costs the part that was read.
+class MappedFile : public NonCopyable
+{
+public:
+    /// @brief Default Constructor
+    MappedFile();
+
+    /// @brief Maps a file, throws if the file could not be opened or mapped.
+    /// @param[in] path Path to the file to map.
+    MappedFile(const std::filesystem::path& path);
+
+    /// @brief Move Constructor
+    MappedFile(MappedFile&& rhs);
+
+    /// @brief Destructor, unmaps the file.
+    ~MappedFile();
+
+    /// @brief Move Assign Operator
+    MappedFile& operator=(MappedFile&& rhs);
+
+    /// @brief Returns the bytes of the whole file.
+    std::span<const std::byte> GetData() const;
+
+    /// @brief Returns the path the file was mapped from.
+    const std::filesystem::path& GetPath() const;
+
+    /// @brief Asks the system to start reading a range of the file in the background, so
+    /// touching it later doesn't fault in one page at a time. Only a hint, it may do nothing.
+    /// @param[in] offset Bytes from the start of the file.
+    /// @param[in] size Bytes to read, clamped to the end of the file.
+    void Prefetch(size_t offset, size_t size) const;
+
+private:
+    void Unmap();
+
+    std::filesystem::path _path;
+    const std::byte* _data;
+    size_t _size;
+    void* _handle; /** @brief The file mapping object on Windows, unused elsewhere. */
+};
+
+} // namespace bl
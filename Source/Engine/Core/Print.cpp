@@ -7,6 +7,7 @@ namespace logging
 {
 
 static bool useVerboseLogging;
+static thread_local std::string* captureBuffer = nullptr;
 
 void enableVerboseLogging(bool enable)
 {
@@ -18,6 +19,28 @@ bool isVerboseLogging()
     return useVerboseLogging;
 }
 
+void beginCapture(std::string* buffer)
+{
+    captureBuffer = buffer;
+}
+
+void endCapture()
+{
+    captureBuffer = nullptr;
+}
+
+void write(const fmt::text_style& style, std::string_view message)
+{
+    // Styling is applied up front so captured output replays exactly as it would've printed.
+    if (captureBuffer)
+    {
+        fmt::format_to(std::back_inserter(*captureBuffer), style, "{}", message);
+        return;
+    }
+
+    fmt::print(style, "{}", message);
+}
+
 }
 
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdlib>
+#include <string>
+#include <string_view>
 
 #include <fmt/core.h>
 #include <fmt/color.h>
@@ -10,31 +12,35 @@
 
 #include "PathUtils.h"
 
-namespace bl 
+namespace bl
 {
 
-namespace logging 
+namespace logging
 {
     void enableVerboseLogging(bool enable);
     bool isVerboseLogging();
+
+    void beginCapture(std::string* buffer); /** @brief Redirects the calling thread's log output into a buffer instead of stdout. */
+    void endCapture(); /** @brief Stops redirecting the calling thread's log output. */
+    void write(const fmt::text_style& style, std::string_view message); /** @brief Writes a styled message to stdout or the capture buffer. */
 }
 
 extern bool useVerboseLogging;
 
 #define blDebug(FORMAT, ...) \
-    fmt::print(fg(fmt::color::orange), "DEBUG {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__))
+    bl::logging::write(fg(fmt::color::orange), fmt::format("DEBUG {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__)))
 
 #define blVerbose(FORMAT, ...) \
     if (bl::logging::isVerboseLogging()) \
-        fmt::print(fg(fmt::color::blanched_almond), "VERBOSE {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__))
+        bl::logging::write(fg(fmt::color::blanched_almond), fmt::format("VERBOSE {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__)))
 
 #define blInfo(FORMAT, ...) \
-    fmt::print(fg(fmt::color::white), "INFO {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__))
+    bl::logging::write(fg(fmt::color::white), fmt::format("INFO {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__)))
 
 #define blWarning(FORMAT, ...) \
-    fmt::print(fg(fmt::color::yellow), "WARNING {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__))
+    bl::logging::write(fg(fmt::color::yellow), fmt::format("WARNING {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__)))
 
 #define blError(FORMAT, ...) \
-    fmt::print(bg(fmt::color::red), "ERROR {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__))
+    bl::logging::write(bg(fmt::color::red), fmt::format("ERROR {} {} {} : {}\n", bl::PathUtils::GetFilename(__FILE__), __LINE__, __func__, fmt::format(FMT_COMPILE(FORMAT) __VA_OPT__(,) __VA_ARGS__)))
 
 } // namespace bl
@@ -1,72 +1,114 @@
 #pragma once
 
-#include "Core/NonMoveable.h"
+#include <atomic>
+#include <type_traits>
+#include <utility>
 
 namespace bl {
 
 /// @brief Any class that needs to know how many times it's being used.
+///
+/// The count is atomic, references may be taken and dropped on any thread. Nothing
+/// is deleted when it reaches zero, whoever owns the object decides what to do then.
 class ReferenceCounted {
 public:
-    ReferenceCounted() = default;
+    ReferenceCounted() : _count(0) {}
     ~ReferenceCounted() = default;
 
-    int GetReferenceCount();
+    int GetReferenceCount() const { return _count.load(std::memory_order_acquire); }
 
 protected:
     template<typename T>
     friend class ReferenceCounter;
 
-    void IncreaseRefs() { _count++; }
-    void DecreaseRefs() { _count--; }
+    void IncreaseRefs() { _count.fetch_add(1, std::memory_order_relaxed); }
+    void DecreaseRefs() { _count.fetch_sub(1, std::memory_order_acq_rel); } /** @brief Acquire release, so an owner that sees zero sees everything done through the last reference. */
 
 private:
-    int _count;
+    std::atomic<int> _count;
 };
 
+/// @brief Holds a reference to a counted object for as long as it lives.
 template<typename T>
-class ReferenceCounter : public NonMoveable {
+class ReferenceCounter {
     static_assert(std::is_base_of_v<ReferenceCounted, T>);
 public:
     ReferenceCounter()
+        : _value(nullptr)
     {
     }
 
     ReferenceCounter(T* value)
         : _value(value)
-    { 
-        _value->IncreaseRefs(); 
+    {
+        if (_value)
+            _value->IncreaseRefs();
     }
-    
+
     ReferenceCounter(const ReferenceCounter& copy)
         : _value(copy._value)
     {
-        _value = copy._value;
-
         if (_value)
             _value->IncreaseRefs();
     }
 
+    ReferenceCounter(ReferenceCounter&& move) noexcept
+        : _value(std::exchange(move._value, nullptr))
+    {
+    }
+
+    /** @brief From a reference to a derived type, a Texture2D reference is a Texture reference. */
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    ReferenceCounter(const ReferenceCounter<U>& copy)
+        : ReferenceCounter(static_cast<T*>(copy.Get()))
+    {
+    }
+
     ~ReferenceCounter()
-    { 
-        if (_value)
-            _value->DecreaseRefs(); 
+    {
+        Reset();
     }
 
     ReferenceCounter& operator=(const ReferenceCounter& rhs)
     {
-        _value = rhs._value;
-        if (_value)
-            _value->IncreaseRefs();
+        // Taken before the old one is dropped, assigning a reference to itself keeps it alive.
+        ReferenceCounter copy{rhs};
+        std::swap(_value, copy._value);
         return *this;
     }
 
+    ReferenceCounter& operator=(ReferenceCounter&& rhs) noexcept
+    {
+        ReferenceCounter moved{std::move(rhs)};
+        std::swap(_value, moved._value);
+        return *this;
+    }
+
+    void Reset() /** @brief Drops the reference, leaving this empty. */
+    {
+        if (_value)
+            _value->DecreaseRefs();
+
+        _value = nullptr;
+    }
+
     T* Get() const
     {
         return _value;
     }
 
+    T* operator->() const
+    {
+        return _value;
+    }
+
+    explicit operator bool() const
+    {
+        return _value != nullptr;
+    }
+
 private:
-    T* _value; /** @brief A reference to our counted resource, should never be nullptr. */
+    T* _value; /** @brief The counted object, nullptr when empty. */
 };
 
-} // namespace bl
\ No newline at end of file
+} // namespace bl
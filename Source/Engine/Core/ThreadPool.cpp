@@ -0,0 +1,56 @@
+#include "ThreadPool.h"
+
+namespace bl
+{
+
+ThreadPool::ThreadPool(uint32_t numThreads)
+    : _stopping(false)
+{
+    numThreads = std::max(numThreads, 1u);
+
+    _threads.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; i++)
+        _threads.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+
+    _condition.notify_all();
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+    return (uint32_t)_threads.size();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this](){ return _stopping || !_jobs.empty(); });
+
+            // Drain the queue before stopping so no future is left without a value.
+            if (_jobs.empty())
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop();
+        }
+
+        job();
+    }
+}
+
+} // namespace bl
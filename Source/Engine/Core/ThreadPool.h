@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace bl
+{
+
+/// @brief A fixed set of worker threads that run submitted jobs in FIFO order.
+///
+/// Jobs are handed out in the order they were submitted, but may finish in any
+/// order. Anything that needs deterministic results should keep the returned
+/// futures in submission order and consume them that way.
+class ThreadPool : public NonCopyable
+{
+public:
+    ThreadPool(uint32_t numThreads = std::thread::hardware_concurrency()); /** @brief Constructor, zero threads is treated as one. */
+    ~ThreadPool(); /** @brief Destructor, finishes every queued job before joining. */
+
+    uint32_t GetThreadCount() const; /** @brief Returns the number of worker threads. */
+
+    /// @brief Queues a job to run on one of the worker threads.
+    /// @param func Callable taking no arguments.
+    /// @returns A future holding the result, or the exception the job threw.
+    template<typename TFunc>
+    auto Submit(TFunc&& func) -> std::future<std::invoke_result_t<TFunc>>;
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> _threads;
+    std::queue<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping;
+};
+
+template<typename TFunc>
+auto ThreadPool::Submit(TFunc&& func) -> std::future<std::invoke_result_t<TFunc>>
+{
+    using TResult = std::invoke_result_t<TFunc>;
+
+    // Packaged tasks are move only, std::function needs something copyable.
+    auto task = std::make_shared<std::packaged_task<TResult()>>(std::forward<TFunc>(func));
+    auto future = task->get_future();
+
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.emplace([task](){ (*task)(); });
+    }
+
+    _condition.notify_one();
+    return future;
+}
+
+} // namespace bl
@@ -33,6 +33,9 @@ public:
     std::unique_ptr<Renderer> CreateRenderer(Window* window);
 
     virtual std::unique_ptr<Resource> BuildResource(ResourceManager* manager, const std::string& type, const std::filesystem::path& path, const nlohmann::json& data);
+    virtual void BeforeUnload(); /** @brief Waits for the device, unloaded resources destroy what in flight frames still use. */
+    virtual void BeginUploads(); /** @brief Batches the uploads of finished loads into one submission. */
+    virtual void EndUploads();
 
 private:
     Engine* _engine;
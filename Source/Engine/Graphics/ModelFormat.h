@@ -2,44 +2,128 @@
 
 #include <cstdint>
 
-#include "Vertex.h"
-
 namespace bl
 {
 
+// Baked models (.bmm) are laid out so the engine can map the file and hand the vertex
+// and index sections straight to the GPU, nothing in them needs parsing or copying.
+//
+// Model (header)
+//  magic       (char[4]) 'B' 'M' 'M' 'F'
+//  version     (uint32_t) ModelVersion
+//  numSections (uint32_t)
+//  flags       (uint32_t)
+//
+// Section Table (ModelSection[numSections]), directly after the header
+//
+// Sections, each starting on a ModelAlignment boundary, in any order
+//  Meshes     (ModelMesh[])
+//  Vertices   every mesh's vertices back to back, a mesh knows its own offset, stride and format
+//  Indices    every mesh's indices back to back, a mesh knows its own offset and index size.
+//             Offsets are a multiple of four so both index types can share one buffer.
+//  Transforms (ModelMatrix[]) model space transform of each mesh
+//  Lods       (ModelLod[]) every mesh's LOD chain, finest first, LOD 0 is the mesh itself
+//  Meshlets   (ModelMeshlet[]) optional, clusters of LOD 0 with culling bounds, ranges of its indices
+//  Materials  (ModelMaterial[]) material references, names live in the strings section
+//  Strings    (char[]) not nul-terminated, referenced by offset and length
+//
+// Readers must ignore section types they don't know so sections can be added without
+// breaking older loaders, changing an existing struct means bumping ModelVersion.
+
+constexpr uint32_t ModelVersion = 5;
+constexpr uint32_t ModelAlignment = 16;
+constexpr uint32_t ModelNoMaterial = UINT32_MAX;
+
+enum class ModelSectionType : uint32_t
+{
+    eMeshes = 0,
+    eVertices = 1,
+    eIndices = 2,
+    eTransforms = 3,
+    eMaterials = 4,
+    eStrings = 5,
+    eLods = 6,
+    eMeshlets = 7,
+};
+
+constexpr uint32_t ModelMeshletMaxVertices = 64;
+constexpr uint32_t ModelMeshletMaxTriangles = 124;
+
 struct ModelHeader
 {
-    uint32_t magic;
-    uint32_t numVertexBuffers;
-    uint32_t numIndexBuffers;
-    uint32_t numTransforms;
-    uint32_t numAnimations;
-    uint32_t numSkeletons;
+    char magic[4];
+    uint32_t version;
+    uint32_t numSections;
+    uint32_t flags;
 };
 
-struct VertexHeader
+struct ModelSection
 {
-    uint32_t numVertices;
+    ModelSectionType type;
+    uint32_t count; /** @brief Number of elements in the section. */
+    uint64_t offset; /** @brief Bytes from the start of the file, a multiple of ModelAlignment. */
+    uint64_t size; /** @brief Size of the section in bytes. */
+    uint32_t stride; /** @brief Size of one element, zero for sections of mixed elements. */
+    uint32_t reserved;
 };
 
-struct IndexHeader
+struct ModelMesh
 {
-    uint32_t numIndices;
+    uint64_t vertexOffset; /** @brief Bytes from the start of the vertices section. */
+    uint64_t indexOffset; /** @brief Bytes from the start of the indices section, a multiple of four. */
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t vertexStride; /** @brief Size of one vertex, sizeof(bl::Vertex) or sizeof(bl::CompactVertex). */
+    uint32_t indexSize; /** @brief Size of one index in bytes, 2 when every index fits in 16 bits, otherwise 4. */
+    uint32_t transformIndex;
+    uint32_t materialIndex; /** @brief Index into the materials section or ModelNoMaterial. */
+    uint32_t vertexFormat; /** @brief A bl::VertexFormat. */
+    float boundsMin[3]; /** @brief Mesh space bounds, compact vertex positions are relative to them. */
+    float boundsMax[3];
+    uint32_t firstLod; /** @brief Index into the lods section. */
+    uint32_t lodCount;
+    uint32_t firstMeshlet; /** @brief Index into the meshlets section. */
+    uint32_t meshletCount; /** @brief Zero when the mesh wasn't split into meshlets. */
+    uint32_t reserved;
+};
+
+struct ModelLod
+{
+    uint64_t indexOffset; /** @brief Bytes from the start of the indices section, same index size as the mesh. */
+    uint32_t indexCount; /** @brief Indices into the mesh's vertices, LODs share them with LOD 0. */
+    float error; /** @brief Largest distance in mesh space the simplified surface moved from LOD 0. */
+};
+
+struct ModelMeshlet
+{
+    uint64_t indexOffset; /** @brief Bytes from the start of the indices section, inside the mesh's LOD 0 range, the mesh's meshlets are back to back. */
+    uint32_t triangleCount; /** @brief At most ModelMeshletMaxTriangles, indexing at most ModelMeshletMaxVertices vertices. */
+    uint32_t vertexCount;
+    float center[3]; /** @brief Mesh space bounding sphere. */
+    float radius;
+    float coneApex[3]; /** @brief Every triangle faces away from cameras inside the cone, dot(normalize(apex - camera), axis) >= cutoff. */
+    float coneAxis[3];
+    float coneCutoff;
+    uint32_t reserved;
 };
 
 struct ModelMatrix
 {
-    float a1, a2, a3, a4;
-    float b1, b2, b3, b4;
-    float c1, c2, c3, c4;
-    float d1, d2, d3, d4;
+    float m[16]; /** @brief Column major, the same layout as glm::mat4. */
 };
 
-struct ModelNode
+struct ModelMaterial
 {
-    uint32_t parentTransformIndex;
-    ModelMatrix matrix;
+    uint32_t nameOffset; /** @brief Bytes from the start of the strings section. */
+    uint32_t nameLength;
+};
 
-}
+static_assert(sizeof(ModelHeader) == 16);
+static_assert(sizeof(ModelSection) == 32);
+static_assert(sizeof(ModelMesh) == 88);
+static_assert(sizeof(ModelLod) == 16);
+static_assert(sizeof(ModelMeshlet) == 64);
+static_assert(sizeof(ModelMatrix) == 64);
+static_assert(sizeof(ModelMaterial) == 8);
 
-}
\ No newline at end of file
+} // namespace bl
@@ -1,4 +1,4 @@
-#include "Graphics/Mesh.h"
+#include "Graphics/StaticMesh.h"
 #include "Graphics/VulkanBuffer.h"
 #include <cstddef>
 
@@ -7,6 +7,13 @@ namespace bl {
 
 void StaticMesh::SetIndices(const std::vector<uint32_t>& indices)
 {
+    // Half the index memory and bandwidth when no index needs more than 16 bits.
+    if (std::all_of(indices.begin(), indices.end(), [](uint32_t index){ return index <= UINT16_MAX; }))
+    {
+        SetIndices(std::vector<uint16_t>(indices.begin(), indices.end()));
+        return;
+    }
+
     // create the staging buffer
     size_t ibSize = sizeof(uint32_t) * indices.size();
 
@@ -14,6 +21,17 @@ void StaticMesh::SetIndices(const std::vector<uint32_t>& indices)
     _indexBuffer = VulkanBuffer{_device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, ibSize};
     _indexBuffer.Upload(bl::vector_as_bytes(indices));
     _indexCount = (uint32_t)indices.size();
+    _indexType = VK_INDEX_TYPE_UINT32;
+}
+
+void StaticMesh::SetIndices(const std::vector<uint16_t>& indices)
+{
+    size_t ibSize = sizeof(uint16_t) * indices.size();
+
+    _indexBuffer = VulkanBuffer{_device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, ibSize};
+    _indexBuffer.Upload(bl::vector_as_bytes(indices));
+    _indexCount = (uint32_t)indices.size();
+    _indexType = VK_INDEX_TYPE_UINT16;
 }
 
 void StaticMesh::Bind(VkCommandBuffer cmd)
@@ -21,7 +39,7 @@ void StaticMesh::Bind(VkCommandBuffer cmd)
     VkDeviceSize offset = 0;
     VkBuffer buffer = _vertexBuffer.Get();
     vkCmdBindVertexBuffers(cmd, 0, 1, &buffer, &offset);
-    vkCmdBindIndexBuffer(cmd, _indexBuffer.Get(), 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindIndexBuffer(cmd, _indexBuffer.Get(), 0, _indexType);
 }
 
 void StaticMesh::Draw(VkCommandBuffer cmd, uint32_t numInstances)
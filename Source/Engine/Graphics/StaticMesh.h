@@ -19,7 +19,9 @@ public:
 
     template<typename TVertex>
     void SetVertices(const std::vector<TVertex>& vertices);
-    void SetIndices(const std::vector<uint32_t>& indices);
+    void SetIndices(const std::vector<uint32_t>& indices); /** @brief Uploads 16 bit indices when every index fits, otherwise 32 bit. */
+    void SetIndices(const std::vector<uint16_t>& indices);
+    void Bind(VkCommandBuffer cmd);
     void Draw(VkCommandBuffer cmd, uint32_t numInstances=1);
 
 private:
@@ -27,7 +29,7 @@ private:
     VulkanBuffer _vertexBuffer;
     VulkanBuffer _indexBuffer;
     uint32_t _indexCount;
-    VulkanMaterialInstance* _material;
+    VkIndexType _indexType;
 };
 
 } // namespace bl
@@ -1,63 +1,395 @@
-#include <assimp/config.h>
-#include <assimp/postprocess.h>
+#include <cstring>
 
-#include "Core/FileByte.h"
-#include "Resource/Resource.h"
-#include "Material.h"
+#include "ModelFormat.h"
 #include "Vertex.h"
-#include "VulkanDevice.h"
 #include "UniformData.h"
 #include "StaticModel.h"
 
 namespace bl
 {
 
-static inline glm::mat4 ConvertMatrixToGLMFormat(const aiMatrix4x4& from)
+static float GetMaxScale(const glm::mat4& model)
 {
-    glm::mat4 to;
-    //the a,b,c,d in assimp is the row ; the 1,2,3,4 is the column
-    to[0][0] = from.a1; to[1][0] = from.a2; to[2][0] = from.a3; to[3][0] = from.a4;
-    to[0][1] = from.b1; to[1][1] = from.b2; to[2][1] = from.b3; to[3][1] = from.b4;
-    to[0][2] = from.c1; to[1][2] = from.c2; to[2][2] = from.c3; to[3][2] = from.c4;
-    to[0][3] = from.d1; to[1][3] = from.d2; to[2][3] = from.d3; to[3][3] = from.d4;
-    return to;
+    return std::max({glm::length(glm::vec3{model[0]}), glm::length(glm::vec3{model[1]}), glm::length(glm::vec3{model[2]})});
+}
+
+// A coarser LOD is only picked once its error is this much under the limit, so a mesh near
+// the switching distance doesn't flip between two LODs every frame.
+static constexpr float LodHysteresis = 0.25f;
+
+static std::span<const std::byte> FindSection(std::span<const std::byte> file, std::span<const ModelSection> sections, ModelSectionType type, uint32_t stride, uint32_t* count)
+{
+    for (const auto& section : sections)
+    {
+        if (section.type != type)
+            continue;
+
+        if (section.offset % ModelAlignment != 0 || section.offset > file.size() || section.size > file.size() - section.offset)
+            throw std::runtime_error("Model section is out of bounds.");
+
+        if (stride != 0 && (section.stride != stride || (uint64_t)section.count * stride != section.size))
+            throw std::runtime_error("Model section has an unexpected element size.");
+
+        if (count) *count = section.count;
+        return file.subspan(section.offset, section.size);
+    }
+
+    if (count) *count = 0;
+    return {};
 }
 
 StaticModel::StaticModel(ResourceManager* manager, const nlohmann::json& json, VulkanDevice* device)
     : Resource(manager, json)
     , _device(device)
+    , _vertexFormat(VertexFormat::eFull)
 {
 }
 
 StaticModel::~StaticModel()
 {
+    Unload();
+}
+
+// Host visible, so a loader thread can fill it while the mapped file pages in.
+static std::optional<VulkanBuffer> MakeStaging(VulkanDevice* device, std::span<const std::byte> data)
+{
+    if (data.empty())
+        return std::nullopt;
+
+    VmaAllocationInfo allocInfo = {};
+    std::optional<VulkanBuffer> staging{std::in_place, device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, data.size(), &allocInfo, true};
+    std::memcpy(allocInfo.pMappedData, data.data(), data.size());
+    return staging;
 }
 
 void StaticModel::Load()
 {
-    std::ifstream modelFile(GetPath());
-    auto  bl::ReadT<uint32_t>(modelFile);
+    LoadData();
+    FinishLoad();
+}
+
+void StaticModel::LoadData()
+{
+    // Mapped straight out of the pack or file, only the copy to staging touches the vertex data.
+    auto data = ReadData();
+    auto file = data.GetSpan();
+    auto name = GetPath().string();
+
+    if (file.size() < sizeof(ModelHeader))
+        throw std::runtime_error("Model is too small to be valid: " + name);
+
+    const auto* header = reinterpret_cast<const ModelHeader*>(file.data());
+    if (std::memcmp(header->magic, "BMMF", 4) != 0 || header->version != ModelVersion)
+        throw std::runtime_error("Model has an invalid header or version, it needs to be baked again: " + name);
+
+    if (sizeof(ModelHeader) + (uint64_t)header->numSections * sizeof(ModelSection) > file.size())
+        throw std::runtime_error("Model section table is out of bounds: " + name);
+
+    std::span<const ModelSection> sections{reinterpret_cast<const ModelSection*>(file.data() + sizeof(ModelHeader)), header->numSections};
+
+    uint32_t numMeshes = 0, numLods = 0, numMeshlets = 0, numTransforms = 0, numMaterials = 0;
+    auto meshData = FindSection(file, sections, ModelSectionType::eMeshes, sizeof(ModelMesh), &numMeshes);
+    auto lodData = FindSection(file, sections, ModelSectionType::eLods, sizeof(ModelLod), &numLods);
+    auto meshletData = FindSection(file, sections, ModelSectionType::eMeshlets, sizeof(ModelMeshlet), &numMeshlets);
+    auto transformData = FindSection(file, sections, ModelSectionType::eTransforms, sizeof(ModelMatrix), &numTransforms);
+    auto materialData = FindSection(file, sections, ModelSectionType::eMaterials, sizeof(ModelMaterial), &numMaterials);
+    auto vertexData = FindSection(file, sections, ModelSectionType::eVertices, 0, nullptr);
+    auto indexData = FindSection(file, sections, ModelSectionType::eIndices, 0, nullptr);
+    auto stringData = FindSection(file, sections, ModelSectionType::eStrings, 0, nullptr);
+
+    std::span<const ModelMesh> meshes{reinterpret_cast<const ModelMesh*>(meshData.data()), numMeshes};
+    std::span<const ModelLod> lods{reinterpret_cast<const ModelLod*>(lodData.data()), numLods};
+    std::span<const ModelMeshlet> meshlets{reinterpret_cast<const ModelMeshlet*>(meshletData.data()), numMeshlets};
+    std::span<const ModelMatrix> transforms{reinterpret_cast<const ModelMatrix*>(transformData.data()), numTransforms};
+    std::span<const ModelMaterial> materials{reinterpret_cast<const ModelMaterial*>(materialData.data()), numMaterials};
+
+    // Meshes become draw ranges into the two shared buffers, so they share a layout.
+    _vertexFormat = meshes.empty() ? VertexFormat::eFull : (VertexFormat)meshes[0].vertexFormat;
+    uint32_t vertexStride = _vertexFormat == VertexFormat::eCompact ? sizeof(CompactVertex) : sizeof(Vertex);
+
+    _meshes.reserve(meshes.size());
+    for (const auto& mesh : meshes)
+    {
+        if ((VertexFormat)mesh.vertexFormat != _vertexFormat)
+            throw std::runtime_error("Model meshes must all have the same vertex format: " + name);
+
+        if (mesh.vertexStride != vertexStride || (mesh.indexSize != sizeof(uint16_t) && mesh.indexSize != sizeof(uint32_t)) ||
+            mesh.vertexOffset % mesh.vertexStride != 0 || mesh.indexOffset % mesh.indexSize != 0 ||
+            mesh.vertexOffset + (uint64_t)mesh.vertexCount * mesh.vertexStride > vertexData.size() ||
+            mesh.indexOffset + (uint64_t)mesh.indexCount * mesh.indexSize > indexData.size() ||
+            (uint64_t)mesh.firstLod + mesh.lodCount > lods.size() || mesh.lodCount > UINT8_MAX ||
+            (uint64_t)mesh.firstMeshlet + mesh.meshletCount > meshlets.size() ||
+            mesh.transformIndex >= transforms.size() ||
+            (mesh.materialIndex != ModelNoMaterial && mesh.materialIndex >= materials.size()))
+            throw std::runtime_error("Model mesh is out of bounds: " + name);
+
+        Mesh& out = _meshes.emplace_back();
+        out.vertexOffset = (int32_t)(mesh.vertexOffset / mesh.vertexStride);
+        out.indexType = mesh.indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        out.transformIndex = mesh.transformIndex;
+        out.materialIndex = mesh.materialIndex;
+
+        glm::vec3 min{mesh.boundsMin[0], mesh.boundsMin[1], mesh.boundsMin[2]};
+        glm::vec3 max{mesh.boundsMax[0], mesh.boundsMax[1], mesh.boundsMax[2]};
+        out.boundsCenter = (min + max) * 0.5f;
+        out.boundsRadius = glm::length(max - min) * 0.5f;
+
+        // A mesh without a LOD chain still draws its own indices as LOD 0.
+        out.firstLod = (uint32_t)_lods.size();
+        out.lodCount = std::max(mesh.lodCount, 1u);
+
+        if (mesh.lodCount == 0)
+            _lods.push_back({(uint32_t)(mesh.indexOffset / mesh.indexSize), mesh.indexCount, 0.0f});
+
+        for (const auto& lod : lods.subspan(mesh.firstLod, mesh.lodCount))
+        {
+            if (lod.indexOffset % mesh.indexSize != 0 || lod.indexOffset + (uint64_t)lod.indexCount * mesh.indexSize > indexData.size())
+                throw std::runtime_error("Model LOD is out of bounds: " + name);
+
+            _lods.push_back({(uint32_t)(lod.indexOffset / mesh.indexSize), lod.indexCount, lod.error});
+        }
+
+        out.firstMeshlet = (uint32_t)_meshlets.size();
+        out.meshletCount = mesh.meshletCount;
+
+        for (const auto& meshlet : meshlets.subspan(mesh.firstMeshlet, mesh.meshletCount))
+        {
+            if (meshlet.indexOffset % mesh.indexSize != 0 || meshlet.indexOffset + (uint64_t)meshlet.triangleCount * 3 * mesh.indexSize > indexData.size())
+                throw std::runtime_error("Model meshlet is out of bounds: " + name);
+
+            Meshlet& m = _meshlets.emplace_back();
+            m.firstIndex = (uint32_t)(meshlet.indexOffset / mesh.indexSize);
+            m.indexCount = meshlet.triangleCount * 3;
+            m.center = {meshlet.center[0], meshlet.center[1], meshlet.center[2]};
+            m.radius = meshlet.radius;
+            m.coneApex = {meshlet.coneApex[0], meshlet.coneApex[1], meshlet.coneApex[2]};
+            m.coneAxis = {meshlet.coneAxis[0], meshlet.coneAxis[1], meshlet.coneAxis[2]};
+            m.coneCutoff = meshlet.coneCutoff;
+        }
+
+        if (_vertexFormat == VertexFormat::eCompact)
+        {
+            out.positionScale = glm::vec4{max - min, 0.0f};
+            out.positionOffset = glm::vec4{min, (float)VertexFormat::eCompact};
+        }
+        else
+        {
+            out.positionScale = glm::vec4{1.0f};
+            out.positionOffset = glm::vec4{0.0f};
+        }
+    }
+
+    // ModelMatrix has the same column major layout as glm::mat4.
+    const auto* matrices = reinterpret_cast<const glm::mat4*>(transforms.data());
+    _transforms.assign(matrices, matrices + transforms.size());
+
+    _materials.reserve(materials.size());
+    for (const auto& material : materials)
+    {
+        if ((uint64_t)material.nameOffset + material.nameLength > stringData.size())
+            throw std::runtime_error("Model material name is out of bounds: " + name);
+
+        _materials.emplace_back(reinterpret_cast<const char*>(stringData.data()) + material.nameOffset, material.nameLength);
+    }
+
+    _vertexStaging = MakeStaging(_device, vertexData);
+    _indexStaging = MakeStaging(_device, indexData);
+}
+
+void StaticModel::FinishLoad()
+{
+    // One upload per section, load time is bound by the copy to the GPU.
+    if (_vertexStaging)
+    {
+        _vertexBuffer = VulkanBuffer{_device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, _vertexStaging->GetSize()};
+        _vertexBuffer.Upload(std::move(*_vertexStaging));
+        _vertexStaging.reset();
+    }
+
+    if (_indexStaging)
+    {
+        _indexBuffer = VulkanBuffer{_device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, _indexStaging->GetSize()};
+        _indexBuffer.Upload(std::move(*_indexStaging));
+        _indexStaging.reset();
+    }
+
+    Resource::Load();
 }
 
 void StaticModel::Unload()
 {
     _meshes.clear();
+    _lods.clear();
+    _meshlets.clear();
+    _transforms.clear();
+    _materials.clear();
+    _vertexBuffer = {};
+    _indexBuffer = {};
+    _vertexStaging.reset();
+    _indexStaging.reset();
+    Resource::Unload();
+}
+
+ResourceMemory StaticModel::GetMemoryUsage() const
+{
+    ResourceMemory memory;
+    memory.cpuBytes = _meshes.size() * sizeof(Mesh) + _lods.size() * sizeof(Lod) + _meshlets.size() * sizeof(Meshlet) + _transforms.size() * sizeof(glm::mat4);
+    memory.gpuBytes = (std::size_t)(_vertexBuffer.GetSize() + _indexBuffer.GetSize());
+    return memory;
+}
+
+void StaticModel::Draw(VulkanMaterialInstance* material, VulkanRenderData& rd)
+{
+    DrawMeshes(material, rd, nullptr, nullptr);
+}
+
+void StaticModel::Draw(VulkanMaterialInstance* material, VulkanRenderData& rd, const ModelView& view, StaticModelInstance& instance)
+{
+    instance.lods.resize(_meshes.size(), 0);
+
+    for (size_t i = 0; i < _meshes.size(); i++)
+    {
+        const auto& mesh = _meshes[i];
+        instance.lods[i] = (uint8_t)SelectLod(mesh, instance.world * _transforms[mesh.transformIndex], view, instance.lods[i]);
+    }
+
+    DrawMeshes(material, rd, &view, &instance);
+}
+
+uint32_t StaticModel::SelectLod(const Mesh& mesh, const glm::mat4& model, const ModelView& view, uint32_t current) const
+{
+    if (mesh.lodCount == 1)
+        return 0;
+
+    // Errors and bounds are in mesh space, the largest axis scale takes them to world space.
+    float scale = GetMaxScale(model);
+    glm::vec3 center = glm::vec3{model * glm::vec4{mesh.boundsCenter, 1.0f}};
+    float distance = glm::length(view.position - center) - mesh.boundsRadius * scale;
+
+    // Inside the bounds any simplification could be right in front of the camera.
+    if (distance <= 0.0f)
+        return 0;
+
+    auto pixelError = [&](uint32_t lod){
+        return _lods[mesh.firstLod + lod].error * scale / distance * view.projectionScale;
+    };
+
+    uint32_t lod = std::min(current, mesh.lodCount - 1);
+
+    while (lod > 0 && pixelError(lod) > view.maxPixelError)
+        lod--;
+
+    while (lod + 1 < mesh.lodCount && pixelError(lod + 1) <= view.maxPixelError * (1.0f - LodHysteresis))
+        lod++;
+
+    return lod;
+}
+
+bool StaticModel::IsMeshletVisible(const Meshlet& meshlet, const glm::mat4& model, float scale, const ModelView& view) const
+{
+    glm::vec3 center = glm::vec3{model * glm::vec4{meshlet.center, 1.0f}};
+    if (!view.frustum->IntersectsSphere(center, meshlet.radius * scale))
+        return false;
+
+    // Every triangle faces away from a camera inside the normal cone.
+    glm::vec3 apex = glm::vec3{model * glm::vec4{meshlet.coneApex, 1.0f}};
+    glm::vec3 axis = glm::normalize(glm::vec3{model * glm::vec4{meshlet.coneAxis, 0.0f}});
+    return glm::dot(glm::normalize(apex - view.position), axis) < meshlet.coneCutoff;
 }
 
-void StaticModel::Draw(MaterialInstance* mat, VulkanRenderData& rd)
+void StaticModel::DrawMeshes(VulkanMaterialInstance* material, VulkanRenderData& rd, const ModelView* view, StaticModelInstance* instance)
 {
-    for (int i = 0; i < (int)_meshes.size(); i++)
+    if (_meshes.empty())
+        return;
+
+    VkDeviceSize offset = 0;
+    VkBuffer buffer = _vertexBuffer.Get();
+    vkCmdBindVertexBuffers(rd.cmd, 0, 1, &buffer, &offset);
+
+    // Both index types share the buffer from offset zero, only a change of type rebinds.
+    std::optional<VkIndexType> boundIndexType;
+
+    glm::mat4 world = instance ? instance->world : glm::mat4{1.0f};
+    bool culling = view && view->frustum;
+
+    if (instance)
     {
-        auto& mesh = _meshes[i];
+        instance->drawnMeshlets = 0;
+        instance->culledMeshlets = 0;
+    }
+
+    for (size_t i = 0; i < _meshes.size(); i++)
+    {
+        const auto& mesh = _meshes[i];
+        uint32_t lodIndex = instance ? instance->lods[i] : 0;
+        const auto& lod = _lods[mesh.firstLod + lodIndex];
+
         ObjectPC obj;
-        obj.model = _transforms[_meshTransformIndicies[i]];
+        obj.model = world * _transforms[mesh.transformIndex];
+        obj.positionScale = mesh.positionScale;
+        obj.positionOffset = mesh.positionOffset;
+
+        float scale = GetMaxScale(obj.model);
+        if (culling && !view->frustum->IntersectsSphere(glm::vec3{obj.model * glm::vec4{mesh.boundsCenter, 1.0f}}, mesh.boundsRadius * scale))
+            continue;
+
+        if (boundIndexType != mesh.indexType)
+        {
+            vkCmdBindIndexBuffer(rd.cmd, _indexBuffer.Get(), 0, mesh.indexType);
+            boundIndexType = mesh.indexType;
+        }
+
+        material->PushConstant(rd, 0, sizeof(ObjectPC), &obj);
 
-        mat->PushConstant(rd, 0, sizeof(ObjectPC), &obj);
-        mesh.bind(rd.cmd);
-        mesh.draw(rd.cmd);
+        if (!culling || lodIndex != 0 || mesh.meshletCount == 0)
+        {
+            vkCmdDrawIndexed(rd.cmd, lod.indexCount, 1, lod.firstIndex, mesh.vertexOffset, 0);
+            continue;
+        }
+
+        // A mesh's meshlets are back to back, so runs of visible meshlets are one draw.
+        uint32_t runFirst = 0, runCount = 0;
+        for (const auto& meshlet : std::span{_meshlets}.subspan(mesh.firstMeshlet, mesh.meshletCount))
+        {
+            if (!IsMeshletVisible(meshlet, obj.model, scale, *view))
+            {
+                instance->culledMeshlets++;
+                continue;
+            }
+
+            instance->drawnMeshlets++;
+
+            if (runCount > 0 && runFirst + runCount == meshlet.firstIndex)
+            {
+                runCount += meshlet.indexCount;
+                continue;
+            }
+
+            if (runCount > 0)
+                vkCmdDrawIndexed(rd.cmd, runCount, 1, runFirst, mesh.vertexOffset, 0);
+
+            runFirst = meshlet.firstIndex;
+            runCount = meshlet.indexCount;
+        }
+
+        if (runCount > 0)
+            vkCmdDrawIndexed(rd.cmd, runCount, 1, runFirst, mesh.vertexOffset, 0);
     }
 }
 
+const std::vector<std::string>& StaticModel::GetMaterialNames() const
+{
+    return _materials;
+}
+
+VertexFormat StaticModel::GetVertexFormat() const
+{
+    return _vertexFormat;
+}
 
+ModelView ModelView::FromPerspective(glm::vec3 position, float fovY, float viewportHeight, float maxPixelError)
+{
+    return {position, viewportHeight / (2.0f * std::tan(fovY * 0.5f)), maxPixelError};
+}
 
-}
\ No newline at end of file
+} // namespace bl
@@ -1,14 +1,43 @@
 #pragma once
 
-#include "Graphics/MaterialInstance.h"
+#include "Graphics/VulkanBuffer.h"
 #include "Graphics/VulkanDevice.h"
+#include "Graphics/VulkanMaterialInstance.h"
 #include "Graphics/VulkanRenderData.h"
+#include "Graphics/Vertex.h"
 #include "Resource/Resource.h"
-#include "Mesh.h"
+#include "Math/Frustum.h"
+#include "Math/Math.h"
 
 namespace bl
 {
 
+/// @brief The camera a model is drawn from, picks the LOD of each mesh and culls.
+struct ModelView
+{
+    glm::vec3 position; /** @brief Camera position in world space. */
+    float projectionScale; /** @brief Viewport height in pixels over 2 * tan(fovY / 2), projects a world space error at a distance to pixels. */
+    float maxPixelError = 1.0f; /** @brief Largest error a LOD may show on screen, in pixels. */
+    std::optional<Frustum> frustum; /** @brief When set meshes outside it are skipped, meshes drawn at LOD 0 also cull their meshlets. */
+
+    static ModelView FromPerspective(glm::vec3 position, float fovY, float viewportHeight, float maxPixelError = 1.0f);
+};
+
+/// @brief One placement of a model in the world.
+struct StaticModelInstance
+{
+    glm::mat4 world = glm::mat4{1.0f};
+    std::vector<uint8_t> lods; /** @brief LOD each mesh was drawn with last, hysteresis needs it to keep LODs from flickering. */
+    uint32_t drawnMeshlets = 0; /** @brief Meshlets drawn and culled by the last draw. */
+    uint32_t culledMeshlets = 0;
+};
+
+/// @brief A model baked into the BMMF format, see Graphics/ModelFormat.h.
+///
+/// Every mesh of the model shares one vertex and one index buffer, loading uploads
+/// the model's vertex and index sections straight from the mapped file. Materials
+/// drawing it need a pipeline using the vertex layout of GetVertexFormat(), see
+/// VulkanPipelineStateInfo::VertexState::SetVertexFormat.
 class StaticModel : public Resource
 {
 public:
@@ -17,16 +46,65 @@ public:
 
     virtual void Load() override;
     virtual void Unload() override;
+    virtual void LoadData() override; /** @brief Reads the mesh tables and copies the vertex and index sections into staging buffers. */
+    virtual void FinishLoad() override; /** @brief Creates the GPU buffers and records the copies from staging. */
+    virtual ResourceMemory GetMemoryUsage() const override;
 
-    void Draw(VulkanRenderData& rd);
+    void Draw(VulkanMaterialInstance* material, VulkanRenderData& rd); /** @brief Draws every mesh at full detail. */
+    void Draw(VulkanMaterialInstance* material, VulkanRenderData& rd, const ModelView& view, StaticModelInstance& instance); /** @brief Draws an instance, each mesh at the coarsest LOD within the view's pixel error. */
+    const std::vector<std::string>& GetMaterialNames() const; /** @brief Names of the materials the meshes reference by index. */
+    VertexFormat GetVertexFormat() const; /** @brief The vertex layout every mesh of this model was baked with. */
 
 private:
+    struct Mesh
+    {
+        int32_t vertexOffset; /** @brief First vertex of the mesh in the shared vertex buffer. */
+        VkIndexType indexType; /** @brief 16 bit when the mesh has few enough vertices. */
+        uint32_t firstLod; /** @brief Index into _lods, finest first. */
+        uint32_t lodCount;
+        uint32_t transformIndex;
+        uint32_t materialIndex;
+        glm::vec4 positionScale; /** @brief Decodes compact positions, see ObjectPC. */
+        glm::vec4 positionOffset;
+        glm::vec3 boundsCenter; /** @brief Mesh space bounding sphere, LOD selection measures distance to it. */
+        float boundsRadius;
+        uint32_t firstMeshlet; /** @brief Index into _meshlets. */
+        uint32_t meshletCount;
+    };
+
+    struct Meshlet
+    {
+        uint32_t firstIndex; /** @brief In the shared index buffer, the mesh's meshlets are back to back. */
+        uint32_t indexCount;
+        glm::vec3 center; /** @brief Mesh space bounding sphere. */
+        float radius;
+        glm::vec3 coneApex; /** @brief Mesh space normal cone, see bl::ModelMeshlet. */
+        glm::vec3 coneAxis;
+        float coneCutoff;
+    };
+
+    struct Lod
+    {
+        uint32_t firstIndex; /** @brief First index in the shared index buffer, counted in indices of the mesh's type. */
+        uint32_t indexCount;
+        float error; /** @brief Mesh space error compared to LOD 0. */
+    };
+
+    uint32_t SelectLod(const Mesh& mesh, const glm::mat4& model, const ModelView& view, uint32_t current) const;
+    bool IsMeshletVisible(const Meshlet& meshlet, const glm::mat4& model, float scale, const ModelView& view) const;
+    void DrawMeshes(VulkanMaterialInstance* material, VulkanRenderData& rd, const ModelView* view, StaticModelInstance* instance);
 
     VulkanDevice* _device;
-    std::vector<StaticMesh> _meshes;
-    std::vector<ResourceRef<MaterialInstance>> _materials;
+    VertexFormat _vertexFormat;
+    VulkanBuffer _vertexBuffer;
+    VulkanBuffer _indexBuffer;
+    std::optional<VulkanBuffer> _vertexStaging; /** @brief Between LoadData() and FinishLoad(), empty sections have none. */
+    std::optional<VulkanBuffer> _indexStaging;
+    std::vector<Mesh> _meshes;
+    std::vector<Lod> _lods;
+    std::vector<Meshlet> _meshlets;
     std::vector<glm::mat4> _transforms;
-    std::vector<int> _meshTransformIndicies;
+    std::vector<std::string> _materials;
 };
 
-}
\ No newline at end of file
+} // namespace bl
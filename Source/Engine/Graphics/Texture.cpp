@@ -1,5 +1,5 @@
 #include "Core/Print.h"
-#include "Graphics/Mesh.h"
+#include "TextureFileFormat.h"
 #include "Texture.h"
 
 #include "qoixx.hpp"
@@ -11,6 +11,7 @@ namespace bl {
 
 Texture::Texture(ResourceManager* manager, const nlohmann::json& data)
     : Resource(manager, data) 
+    , _stripeRows(0)
 {
 }
 
@@ -22,16 +23,9 @@ void Texture::Load()
 {
     std::filesystem::path path = GetPath();
 
-    // Readin the image file to a buffer.
-    std::ifstream file{path, std::ios::binary};
-
-    file.seekg(0, std::ios::end);
-    std::size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<std::byte> buffer{size};
-    file.read(reinterpret_cast<char*>(buffer.data()), size);
-    buffer.resize(file.tellg());
+    // Read in the image file, straight out of a pack when there is one.
+    auto data = ReadData();
+    auto buffer = data.GetSpan();
 
     // Use the extension to determine the file type.
     std::string extension = path.extension().string();
@@ -48,6 +42,10 @@ void Texture::Load()
     {
         DecodeQOI(buffer);
     } 
+    else if (extension == ".bmt") 
+    {
+        ReadBMT(std::move(data));
+    } 
     else 
     {
         blError("Invalid texture extension cannot parse image: {}", path.string());
@@ -59,10 +57,18 @@ void Texture::Load()
 
 void Texture::Unload() 
 {
-    _imageData.resize(0);
+    _data = {};
+    _imageData = {};
+    _mips.clear();
+    _stripeRows = 0;
+    _stripedLevels.clear();
     Resource::Unload();
 }
 
+ResourceMemory Texture::GetMemoryUsage() const {
+    return ResourceMemory{_data.GetSize(), 0};
+}
+
 VkExtent2D Texture::GetExtent() const {
     return _extent;
 }
@@ -79,34 +85,228 @@ std::span<const std::byte> Texture::GetImageData() const {
     return _imageData;
 }
 
-void Texture::DecodePNG(const std::vector<std::byte>& data) {
+std::span<const TextureMip> Texture::GetMips() const {
+    return _mips;
+}
+
+std::size_t Texture::GetImageSize() const {
+    return _mips.empty() ? 0 : _mips.back().offset + _mips.back().size;
+}
+
+void Texture::CopyImageData(std::span<std::byte> destination) const {
+    if (destination.size() < GetImageSize())
+        throw std::runtime_error("Texture copy destination is too small: " + GetPath().string());
+
+    if (_stripedLevels.empty()) {
+        std::memcpy(destination.data(), _imageData.data(), _imageData.size());
+        return;
+    }
+
+    // Each stripe decodes into its own rows of the destination, every stripe of every level is its own job.
+    std::vector<std::future<void>> jobs;
+    for (std::size_t i = 0; i < _mips.size(); i++) {
+        const auto& mip = _mips[i];
+        auto coded = _stripedLevels[i];
+        auto stripes = reinterpret_cast<const TextureStripe*>(coded.data());
+        std::size_t rowSize = (std::size_t)mip.extent.width * 4;
+        uint32_t stripeCount = (mip.extent.height + _stripeRows - 1) / _stripeRows;
+
+        for (uint32_t stripe = 0; stripe < stripeCount; stripe++) {
+            uint32_t rows = std::min(_stripeRows, mip.extent.height - stripe * _stripeRows);
+            auto source = coded.subspan(stripes[stripe].offset, stripes[stripe].size);
+            auto target = destination.subspan(mip.offset + stripe * _stripeRows * rowSize, rows * rowSize);
+
+            jobs.push_back(GetWorkerPool().Submit([source, target, width = mip.extent.width, rows](){
+                DecodeQOIStripe(source, target, width, rows);
+            }));
+        }
+    }
+
+    // Every job has to be done with the destination before an error leaves this function.
+    for (auto& job : jobs)
+        job.wait();
+
+    for (auto& job : jobs)
+        job.get();
+}
+
+void Texture::DecodePNG(std::span<const std::byte> data) {
     int x = 0, y = 0, channels = 0;
     stbi_uc* image = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()), (int)data.size(), &x, &y, &channels, STBI_rgb_alpha);
 
     std::size_t byteCount = x * y * 4;
-    _imageData.resize(byteCount);
-    std::memcpy(_imageData.data(), image, byteCount);
+    std::vector<std::byte> pixels(byteCount);
+    std::memcpy(pixels.data(), image, byteCount);
 
     _format = TextureFormat::eRGBA;
     _colorSpace = TextureColorSpace::eSRGB;
     _extent = {(uint32_t)x, (uint32_t)y};
+    _data = ResourceData{std::move(pixels)};
+    _imageData = _data.GetSpan();
+    _mips = {{_extent, 0, byteCount}};
 
     stbi_image_free(image);
 }
 
-void Texture::DecodeQOI(const std::vector<std::byte>& data) {
+void Texture::DecodeQOI(std::span<const std::byte> data) {
     using namespace qoixx;
 
-    const auto [actual, desc] = qoi::decode<std::vector<std::byte>>(data, 4);
-    _imageData = actual;
+    auto [actual, desc] = qoi::decode<std::vector<std::byte>>(data.data(), data.size(), 4);
+    _data = ResourceData{std::move(actual)};
+    _imageData = _data.GetSpan();
 
     _extent = {desc.width, desc.height};
     _format = TextureFormat::eRGBA;
+    _mips = {{_extent, 0, _imageData.size()}};
     
     switch (desc.colorspace) {
-        case qoi::colorspace::linear: _colorSpace = TextureColorSpace::eLinear;
-        case qoi::colorspace::srgb: _colorSpace = TextureColorSpace::eSRGB;
+        case qoi::colorspace::linear: _colorSpace = TextureColorSpace::eLinear; break;
+        case qoi::colorspace::srgb: _colorSpace = TextureColorSpace::eSRGB; break;
     }
 }
 
+void Texture::DecodeQOIStripe(std::span<const std::byte> source, std::span<std::byte> destination, uint32_t width, uint32_t height) {
+    // Decodes straight into the destination rows rather than a buffer of its own, following the QOI specification.
+    constexpr std::size_t headerSize = 14, endSize = 8;
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(source.data());
+    if (source.size() < headerSize + endSize || std::memcmp(bytes, "qoif", 4) != 0)
+        throw std::runtime_error("Texture stripe is not a QOI image.");
+
+    auto readBigEndian = [&](std::size_t at){
+        return (uint32_t)bytes[at] << 24 | (uint32_t)bytes[at + 1] << 16 | (uint32_t)bytes[at + 2] << 8 | (uint32_t)bytes[at + 3];
+    };
+
+    if (readBigEndian(4) != width || readBigEndian(8) != height)
+        throw std::runtime_error("Texture stripe has the wrong size.");
+
+    std::array<std::array<uint8_t, 4>, 64> seen{};
+    std::array<uint8_t, 4> pixel = {0, 0, 0, 255};
+    std::size_t position = headerSize, end = source.size() - endSize;
+    uint32_t run = 0;
+
+    auto take = [&](std::size_t count){
+        if (end - position < count)
+            throw std::runtime_error("Texture stripe ends early.");
+
+        position += count;
+        return bytes + position - count;
+    };
+
+    auto* out = reinterpret_cast<uint8_t*>(destination.data());
+    std::size_t pixelCount = (std::size_t)width * height;
+
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        if (run > 0) {
+            run--;
+        } else {
+            uint8_t op = *take(1);
+
+            if (op == 0xfe) {
+                std::memcpy(pixel.data(), take(3), 3);
+            } else if (op == 0xff) {
+                std::memcpy(pixel.data(), take(4), 4);
+            } else if ((op & 0xc0) == 0x00) {
+                pixel = seen[op];
+            } else if ((op & 0xc0) == 0x40) {
+                pixel[0] += ((op >> 4) & 3) - 2;
+                pixel[1] += ((op >> 2) & 3) - 2;
+                pixel[2] += (op & 3) - 2;
+            } else if ((op & 0xc0) == 0x80) {
+                uint8_t next = *take(1);
+                int green = (op & 0x3f) - 32;
+                pixel[0] += green - 8 + ((next >> 4) & 0x0f);
+                pixel[1] += green;
+                pixel[2] += green - 8 + (next & 0x0f);
+            } else {
+                run = op & 0x3f;
+            }
+
+            seen[(pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64] = pixel;
+        }
+
+        std::memcpy(out + i * 4, pixel.data(), 4);
+    }
+}
+
+void Texture::ReadBMT(ResourceData&& data) {
+    // Nothing is decoded here, the mip levels are used straight out of the mapped file
+    // and striped levels are only decoded once CopyImageData has somewhere to put them.
+    auto file = data.GetSpan();
+    auto name = GetPath().string();
+
+    if (file.size() < sizeof(TextureHeader))
+        throw std::runtime_error("Texture is too small to be valid: " + name);
+
+    const auto* header = reinterpret_cast<const TextureHeader*>(file.data());
+    if (std::memcmp(header->magic, "BMTF", 4) != 0 || header->version != TextureVersion)
+        throw std::runtime_error("Texture has an invalid header or version, it needs to be baked again: " + name);
+
+    if (header->levelCount == 0 || sizeof(TextureHeader) + (uint64_t)header->levelCount * sizeof(TextureLevel) > file.size())
+        throw std::runtime_error("Texture level table is out of bounds: " + name);
+
+    auto pixelFormat = (TexturePixelFormat)header->pixelFormat;
+    switch (pixelFormat) {
+        case TexturePixelFormat::eRGBA8Unorm: _format = TextureFormat::eRGBA; _colorSpace = TextureColorSpace::eLinear; break;
+        case TexturePixelFormat::eRGBA8Srgb: _format = TextureFormat::eRGBA; _colorSpace = TextureColorSpace::eSRGB; break;
+        case TexturePixelFormat::eBC1Unorm: _format = TextureFormat::eBC1; _colorSpace = TextureColorSpace::eLinear; break;
+        case TexturePixelFormat::eBC1Srgb: _format = TextureFormat::eBC1; _colorSpace = TextureColorSpace::eSRGB; break;
+        case TexturePixelFormat::eBC3Unorm: _format = TextureFormat::eBC3; _colorSpace = TextureColorSpace::eLinear; break;
+        case TexturePixelFormat::eBC3Srgb: _format = TextureFormat::eBC3; _colorSpace = TextureColorSpace::eSRGB; break;
+        case TexturePixelFormat::eBC4Unorm: _format = TextureFormat::eBC4; _colorSpace = TextureColorSpace::eLinear; break;
+        case TexturePixelFormat::eBC5Unorm: _format = TextureFormat::eBC5; _colorSpace = TextureColorSpace::eLinear; break;
+        case TexturePixelFormat::eBC7Unorm: _format = TextureFormat::eBC7; _colorSpace = TextureColorSpace::eLinear; break;
+        case TexturePixelFormat::eBC7Srgb: _format = TextureFormat::eBC7; _colorSpace = TextureColorSpace::eSRGB; break;
+        default: throw std::runtime_error("Texture has an unknown pixel format: " + name);
+    }
+
+    bool striped = (header->flags & TextureFlagQoiStripes) != 0;
+    if (striped && (header->stripeRows == 0 || GetTextureBlockSize(pixelFormat) != 0))
+        throw std::runtime_error("Texture has invalid stripes: " + name);
+
+    std::span<const TextureLevel> levels{reinterpret_cast<const TextureLevel*>(file.data() + sizeof(TextureHeader)), header->levelCount};
+
+    // Levels are back to back, so the chain is one range from the first level to the end of the last.
+    uint64_t begin = levels.front().offset;
+    uint64_t end = begin;
+    uint64_t decodedEnd = 0;
+
+    _mips.clear();
+    _stripedLevels.clear();
+    for (const auto& level : levels) {
+        uint64_t decodedSize = GetTextureLevelSize(pixelFormat, level.width, level.height);
+        if (level.offset < end || level.offset > file.size() || level.size > file.size() - level.offset ||
+            (!striped && level.size != decodedSize))
+            throw std::runtime_error("Texture level is out of bounds: " + name);
+
+        end = level.offset + level.size;
+
+        if (!striped) {
+            _mips.push_back({{level.width, level.height}, (std::size_t)(level.offset - begin), (std::size_t)level.size});
+            continue;
+        }
+
+        auto coded = file.subspan(level.offset, level.size);
+        uint64_t stripeCount = (level.height + (uint64_t)header->stripeRows - 1) / header->stripeRows;
+        if (stripeCount * sizeof(TextureStripe) > coded.size())
+            throw std::runtime_error("Texture stripe table is out of bounds: " + name);
+
+        for (const auto& stripe : std::span{reinterpret_cast<const TextureStripe*>(coded.data()), stripeCount}) {
+            if (stripe.offset > coded.size() || stripe.size > coded.size() - stripe.offset)
+                throw std::runtime_error("Texture stripe is out of bounds: " + name);
+        }
+
+        // Decoded levels keep the alignment baked levels have, copies out of them stay aligned.
+        decodedEnd = (decodedEnd + TextureAlignment - 1) / TextureAlignment * TextureAlignment;
+        _mips.push_back({{level.width, level.height}, (std::size_t)decodedEnd, (std::size_t)decodedSize});
+        _stripedLevels.push_back(coded);
+        decodedEnd += decodedSize;
+    }
+
+    _extent = {header->width, header->height};
+    _stripeRows = striped ? header->stripeRows : 0;
+    _data = std::move(data);
+    _imageData = striped ? std::span<const std::byte>{} : _data.GetSpan().subspan(begin, end - begin);
+}
+
 } // namespace bl
\ No newline at end of file
@@ -9,12 +9,18 @@ namespace bl {
 enum class TextureFileType {
     ePNG,
     eQOI,
+    eBMT, /** @brief Baked with its mip chain, see Graphics/TextureFileFormat.h. */
 };
 
 /// @brief Pixel formats that are currently supported for a texture object. 
 enum class TextureFormat {
     eRGB,
     eRGBA,
+    eBC1, /** @brief Block compressed formats, only baked textures use them. */
+    eBC3,
+    eBC4,
+    eBC5,
+    eBC7,
 };
 
 /// @brief Texture color spaces that are currently supported.
@@ -23,6 +29,13 @@ enum class TextureColorSpace {
     eLinear,
 };
 
+/// @brief Where one mip level lives in a texture's image data.
+struct TextureMip {
+    VkExtent2D extent;
+    std::size_t offset; /** @brief Bytes from the start of GetImageData(). */
+    std::size_t size;
+};
+
 /// @brief Generic texture loading resource interface.
 ///
 /// This is a generic texture loader and will load the file generically of 
@@ -38,21 +51,31 @@ public:
 
     virtual void Load() override;
     virtual void Unload() override;
+    virtual ResourceMemory GetMemoryUsage() const override; /** @brief The file or decoded pixels while they're held. */
 
     VkExtent2D GetExtent() const;
     TextureFormat GetFormat() const;
     TextureColorSpace GetColorSpace() const;
-    std::span<const std::byte> GetImageData() const;
+    std::span<const std::byte> GetImageData() const; /** @brief Every mip level back to back, largest first. Empty for striped textures, use CopyImageData. */
+    std::span<const TextureMip> GetMips() const;
+    std::size_t GetImageSize() const; /** @brief Bytes CopyImageData writes. */
+    void CopyImageData(std::span<std::byte> destination) const; /** @brief Writes every mip level laid out as GetMips() describes, striped textures decode their stripes in parallel. */
 
 private:
-    void DecodePNG(const std::vector<std::byte>& buffer);
-    void DecodeQOI(const std::vector<std::byte>& buffer);
+    void DecodePNG(std::span<const std::byte> buffer);
+    void DecodeQOI(std::span<const std::byte> buffer);
+    void ReadBMT(ResourceData&& data);
+    static void DecodeQOIStripe(std::span<const std::byte> source, std::span<std::byte> destination, uint32_t width, uint32_t height);
 
     VkExtent2D _extent;
     TextureFileType _type; 
     TextureFormat _format;
     TextureColorSpace _colorSpace;
-    std::vector<std::byte> _imageData;
+    ResourceData _data; /** @brief The mapped file for baked textures, otherwise the decoded pixels. */
+    std::span<const std::byte> _imageData;
+    std::vector<TextureMip> _mips;
+    uint32_t _stripeRows; /** @brief Non zero for textures baked as QOI stripes, see Graphics/TextureFileFormat.h. */
+    std::vector<std::span<const std::byte>> _stripedLevels; /** @brief The coded bytes of each level of a striped texture. */
 };
 
 } // namespace bl
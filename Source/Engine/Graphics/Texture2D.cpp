@@ -1,5 +1,4 @@
 #include "Texture2D.h"
-#include "Graphics/Mesh.h"
 #include "Graphics/Texture.h"
 #include "Graphics/VulkanImage.h"
 #include "Resource/Resource.h"
@@ -17,6 +16,7 @@ VkExtent3D Make3D(VkExtent2D ex, uint32_t depth = 1) {
 Texture2D::Texture2D(ResourceManager* manager, const nlohmann::json& data, VulkanDevice* device)
     : Texture(manager, data)
     , _device(device) 
+    , _imageSize(0)
 {
 }
 
@@ -26,16 +26,66 @@ Texture2D::~Texture2D()
 
 void Texture2D::Load() 
 {
+    LoadData();
+    FinishLoad();
+}
+
+void Texture2D::LoadData()
+{
+    Texture::Load();
+    if (GetState() != ResourceState::eLoaded)
+        throw std::runtime_error("Could not read texture: " + GetPath().string());
+
+    // Every level goes up in the same staging copy, one region each. Block compressed
+    // levels are copied as they are, the GPU samples them without anything decoding them.
+    auto mips = GetMips();
+
+    _regions.clear();
+    for (uint32_t i = 0; i < mips.size(); i++)
+    {
+        VkBufferImageCopy region{};
+        region.bufferOffset = mips[i].offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = vk::Make3D(mips[i].extent);
+        _regions.push_back(region);
+    }
+
+    // Striped textures decode on the worker pool straight into the staging buffer.
+    VmaAllocationInfo allocInfo = {};
+    _staging.emplace(_device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, GetImageSize(), &allocInfo, true);
+    CopyImageData(std::span<std::byte>{static_cast<std::byte*>(allocInfo.pMappedData), GetImageSize()});
+
+    Texture::Unload();
+}
+
+void Texture2D::FinishLoad()
+{
+    if (!_staging)
+        throw std::runtime_error("Could not finish a texture that wasn't read: " + GetPath().string());
+
     VkFormat format = VK_FORMAT_UNDEFINED;
 
-    static VkFormat formatConversion[2][2] = {
+    static VkFormat formatConversion[2][7] = {
         {
             VK_FORMAT_R8G8B8_SRGB,
-            VK_FORMAT_R8G8B8A8_SRGB
+            VK_FORMAT_R8G8B8A8_SRGB,
+            VK_FORMAT_BC1_RGB_SRGB_BLOCK,
+            VK_FORMAT_BC3_SRGB_BLOCK,
+            VK_FORMAT_BC4_UNORM_BLOCK, // BC4 and BC5 have no sRGB variant, the baker only writes them linear.
+            VK_FORMAT_BC5_UNORM_BLOCK,
+            VK_FORMAT_BC7_SRGB_BLOCK
         },
         {
             VK_FORMAT_R8G8B8_UNORM,
-            VK_FORMAT_R8G8B8A8_UNORM
+            VK_FORMAT_R8G8B8A8_UNORM,
+            VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+            VK_FORMAT_BC3_UNORM_BLOCK,
+            VK_FORMAT_BC4_UNORM_BLOCK,
+            VK_FORMAT_BC5_UNORM_BLOCK,
+            VK_FORMAT_BC7_UNORM_BLOCK
         }
     };
 
@@ -47,17 +97,28 @@ void Texture2D::Load()
         vk::Make3D(GetExtent()),
         format,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_IMAGE_ASPECT_COLOR_BIT};
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        (uint32_t)_regions.size()};
 
-    _image.UploadData(GetImageData(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    _imageSize = (std::size_t)_staging->GetSize();
+    _image.UploadData(std::move(*_staging), _regions, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    _staging.reset();
+    _regions.clear();
 
-    Texture::Unload();
     Resource::Load();
 }
 
 void Texture2D::Unload() {
     _image.Destroy();
-    Resource::Unload();
+    _staging.reset();
+    _regions.clear();
+    _imageSize = 0;
+    Texture::Unload();
+}
+
+ResourceMemory Texture2D::GetMemoryUsage() const {
+    return ResourceMemory{Texture::GetMemoryUsage().cpuBytes, _imageSize};
 }
 
 VulkanImage* Texture2D::GetImage() {
@@ -2,6 +2,7 @@
 
 #include "Resource/Resource.h"
 #include "Texture.h"
+#include "VulkanBuffer.h"
 #include "VulkanImage.h"
 
 namespace bl {
@@ -14,12 +15,18 @@ public:
 
     virtual void Load() override;
     virtual void Unload() override;
+    virtual void LoadData() override; /** @brief Decodes every mip level into a staging buffer, the decoded file is let go right after. */
+    virtual void FinishLoad() override; /** @brief Creates the image and records the copy from the staging buffer. */
+    virtual ResourceMemory GetMemoryUsage() const override;
 
     VulkanImage* GetImage();
 
 private:
     VulkanDevice* _device;
     VulkanImage _image;
+    std::optional<VulkanBuffer> _staging; /** @brief Between LoadData() and FinishLoad(), host visible so it can be written on a loader thread. */
+    std::vector<VkBufferImageCopy> _regions;
+    std::size_t _imageSize; /** @brief Bytes of every mip level, what the image holds on the GPU. */
 };
 
 } // namespace bl
\ No newline at end of file
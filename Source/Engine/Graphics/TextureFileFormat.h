@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bl
+{
+
+// Baked textures (.bmt) carry their whole mip chain in the layout the GPU copies from,
+// the engine maps the file and hands every level to one staging copy without decoding.
+//
+// Texture (header)
+//  magic       (char[4]) 'B' 'M' 'T' 'F'
+//  version     (uint32_t) TextureVersion
+//  width       (uint32_t) of level 0
+//  height      (uint32_t)
+//  levelCount  (uint32_t)
+//  pixelFormat (uint32_t) a TexturePixelFormat
+//  flags       (uint32_t) TextureFlag bits
+//  stripeRows  (uint32_t) rows per stripe of striped textures, zero otherwise
+//
+// Level Table (TextureLevel[levelCount]), directly after the header, largest level first
+//
+// Level data, each level starting on a TextureAlignment boundary. Levels are back to
+// back in table order so the whole chain is one contiguous range of the file.
+// Block compressed levels are rows of 4x4 blocks, partial blocks cover the right and
+// bottom edges, exactly as Vulkan copies them into the matching VK_FORMAT_BC* image.
+//
+// Striped textures (TextureFlagQoiStripes) store RGBA8 levels losslessly as horizontal
+// stripes of stripeRows rows, each coded as its own QOI image so stripes decode in
+// parallel. A striped level starts with TextureStripe[ceil(height / stripeRows)], the
+// level's size is its coded size.
+
+constexpr uint32_t TextureVersion = 2;
+constexpr uint32_t TextureAlignment = 16;
+constexpr uint32_t TextureFlagQoiStripes = 1 << 0;
+
+enum class TexturePixelFormat : uint32_t
+{
+    eRGBA8Unorm = 0,
+    eRGBA8Srgb = 1, /** @brief Color channels are sRGB encoded, alpha is linear. */
+    eBC1Unorm = 2, /** @brief RGB, 8 bytes per block. */
+    eBC1Srgb = 3,
+    eBC3Unorm = 4, /** @brief RGBA, 16 bytes per block. */
+    eBC3Srgb = 5,
+    eBC4Unorm = 6, /** @brief R, 8 bytes per block, for masks. */
+    eBC5Unorm = 7, /** @brief RG, 16 bytes per block, for normal maps. */
+    eBC7Unorm = 8, /** @brief RGBA, 16 bytes per block, for color. */
+    eBC7Srgb = 9,
+};
+
+/** @brief Bytes of one 4x4 block, zero for formats that aren't block compressed. */
+constexpr uint32_t GetTextureBlockSize(TexturePixelFormat format)
+{
+    switch (format)
+    {
+    case TexturePixelFormat::eBC1Unorm:
+    case TexturePixelFormat::eBC1Srgb:
+    case TexturePixelFormat::eBC4Unorm:
+        return 8;
+    case TexturePixelFormat::eBC3Unorm:
+    case TexturePixelFormat::eBC3Srgb:
+    case TexturePixelFormat::eBC5Unorm:
+    case TexturePixelFormat::eBC7Unorm:
+    case TexturePixelFormat::eBC7Srgb:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+/** @brief Bytes one level of the given size takes. */
+constexpr uint64_t GetTextureLevelSize(TexturePixelFormat format, uint32_t width, uint32_t height)
+{
+    uint32_t blockSize = GetTextureBlockSize(format);
+    if (blockSize == 0)
+        return (uint64_t)width * height * 4;
+
+    return (uint64_t)((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+}
+
+struct TextureHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t pixelFormat;
+    uint32_t flags;
+    uint32_t stripeRows;
+};
+
+struct TextureLevel
+{
+    uint64_t offset; /** @brief Bytes from the start of the file, a multiple of TextureAlignment. */
+    uint64_t size; /** @brief Size of the level in bytes. */
+    uint32_t width; /** @brief Half of the level before it rounded down, at least one. */
+    uint32_t height;
+    uint32_t reserved[2];
+};
+
+struct TextureStripe
+{
+    uint64_t offset; /** @brief Bytes from the start of the level. */
+    uint64_t size; /** @brief Size of the QOI coded stripe in bytes. */
+};
+
+static_assert(sizeof(TextureHeader) == 32);
+static_assert(sizeof(TextureLevel) == 32);
+static_assert(sizeof(TextureStripe) == 16);
+
+} // namespace bl
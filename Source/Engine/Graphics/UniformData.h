@@ -28,6 +28,8 @@ struct MaterialBuffer // Slot 1, Binding 0
 struct ObjectPC // Model positions use a push constant block
 {
     alignas(16) glm::mat4 model;
+    alignas(16) glm::vec4 positionScale = glm::vec4{1.0f}; // Compact vertex positions are relative to the mesh bounds,
+    alignas(16) glm::vec4 positionOffset = glm::vec4{0.0f}; // position * scale + offset, w is the bl::VertexFormat.
 };
 
 } // namespace bl
\ No newline at end of file
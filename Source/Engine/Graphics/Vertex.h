@@ -32,6 +32,46 @@ struct Vertex
     }
 };
 
+/// @brief How the vertices of a baked mesh are stored, see bl::Vertex and bl::CompactVertex.
+enum class VertexFormat : uint32_t
+{
+    eFull = 0,
+    eCompact = 1,
+};
+
+/// @brief A 16 byte vertex for baked static meshes, half the size of bl::Vertex.
+///
+/// Positions are 16 bit unorm relative to the mesh bounds, the draw pushes the bounds
+/// with ObjectPC to scale them back. Normals are octahedral encoded into two 16 bit
+/// snorms and texture coordinates are half floats. The default vertex shader decodes
+/// both layouts, the position's fourth component is padding.
+struct CompactVertex
+{
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t texCoords[2];
+
+    static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions()
+    {
+        std::vector<VkVertexInputBindingDescription> descriptions = {
+            { 0, sizeof(bl::CompactVertex), VK_VERTEX_INPUT_RATE_VERTEX}
+        };
+        return descriptions;
+    }
+
+    static std::vector<VkVertexInputAttributeDescription> GetBindingAttributeDescriptions()
+    {
+        std::vector<VkVertexInputAttributeDescription> attributes = {
+            {0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(CompactVertex, position)},
+            {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, normal)},
+            {2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(CompactVertex, texCoords)},
+        };
+        return attributes;
+    }
+};
+
+static_assert(sizeof(CompactVertex) == 16);
+
 struct VoxelVertex
 {
     uint32_t v;
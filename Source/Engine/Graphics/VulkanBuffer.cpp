@@ -129,14 +129,27 @@ void VulkanBuffer::Upload(std::span<const std::byte> data)
         
     std::memcpy(allocInfo.pMappedData, data.data(), _size);
 
+    Upload(std::move(stagingBuffer));
+}
+
+void VulkanBuffer::Upload(VulkanBuffer&& staging)
+{
+    if (staging.GetSize() > _size) {
+        blError("Staging buffer is larger than the buffer it's uploaded to.");
+        return;
+    }
+
     _device->ImmediateSubmit([&](VkCommandBuffer cmd){ 
         VkBufferCopy region = {};
         region.srcOffset = 0;
         region.dstOffset = 0;
-        region.size = _size;
+        region.size = staging.GetSize();
 
-        vkCmdCopyBuffer(cmd, stagingBuffer.Get(), _buffer, 1, &region); 
+        vkCmdCopyBuffer(cmd, staging.Get(), _buffer, 1, &region); 
     });
+
+    // Inside a submit batch the copy hasn't run yet.
+    _device->ReleaseAfterSubmit([buffer = std::make_shared<VulkanBuffer>(std::move(staging))]() mutable { buffer.reset(); });
 }
 
 void VulkanBuffer::Flush(VkDeviceSize offset, VkDeviceSize size)
@@ -21,6 +21,7 @@ public:
     void Map(void** mapped);
     void Unmap();
     void Upload(std::span<const std::byte> data); /** @brief Uploads a portion of memory to the buffer on the GPU immediately. */
+    void Upload(VulkanBuffer&& staging); /** @brief Copies a staging buffer filled ahead of time into the start of this one, keeping it alive until the copy has run. */
     void Flush(VkDeviceSize offset, VkDeviceSize size);
 
 private:
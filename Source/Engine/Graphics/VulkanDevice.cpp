@@ -44,6 +44,8 @@ namespace bl {
 VulkanDevice::VulkanDevice()
     : _descriptorSetLayoutCache(this)
     , _pipelineLayoutCache(this) 
+    , _batch(VK_NULL_HANDLE)
+    , _batchDepth(0)
 {
 }
 
@@ -52,6 +54,8 @@ VulkanDevice::VulkanDevice(VulkanInstance* instance, VulkanPhysicalDevice* physi
     , _physicalDevice(physicalDevice)
     , _descriptorSetLayoutCache(this)
     , _pipelineLayoutCache(this) 
+    , _batch(VK_NULL_HANDLE)
+    , _batchDepth(0)
 {
     CreateDevice();
     CreateCommandPool();
@@ -77,6 +81,9 @@ VulkanDevice& VulkanDevice::operator=(VulkanDevice&& move) noexcept
     _allocator = move._allocator;
     _descriptorSetLayoutCache = std::move(move._descriptorSetLayoutCache);
     _pipelineLayoutCache = std::move(move._pipelineLayoutCache);
+    _batch = move._batch;
+    _batchDepth = move._batchDepth;
+    _batchReleases = std::move(move._batchReleases);
     return *this;
 }
 
@@ -132,6 +139,13 @@ VmaAllocator VulkanDevice::GetAllocator() const
 
 void VulkanDevice::ImmediateSubmit(const std::function<void(VkCommandBuffer)>& recorder)
 {
+    // Batched commands run in the order they're recorded, same as separate submissions would.
+    if (_batch != VK_NULL_HANDLE)
+    {
+        recorder(_batch);
+        return;
+    }
+
     // Allocate the command buffer used to record the submission.
     VkCommandBufferAllocateInfo allocateInfo = {};
     allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -170,6 +184,67 @@ void VulkanDevice::ImmediateSubmit(const std::function<void(VkCommandBuffer)>& r
     VK_CHECK(vkQueueSubmit(_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE))
 
     WaitForDevice();
+    vkFreeCommandBuffers(_device, _commandPool, 1, &cmd);
+}
+
+void VulkanDevice::BeginSubmitBatch()
+{
+    if (_batchDepth++ > 0)
+        return;
+
+    VkCommandBufferAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.pNext = nullptr;
+    allocateInfo.commandPool = _commandPool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = 1;
+
+    VK_CHECK(vkAllocateCommandBuffers(_device, &allocateInfo, &_batch))
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext = nullptr;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr;
+
+    VK_CHECK(vkBeginCommandBuffer(_batch, &beginInfo))
+}
+
+void VulkanDevice::EndSubmitBatch()
+{
+    if (_batchDepth == 0 || --_batchDepth > 0)
+        return;
+
+    // Taken first, so anything below submits on its own instead of into a finished batch.
+    VkCommandBuffer cmd = _batch;
+    _batch = VK_NULL_HANDLE;
+
+    VK_CHECK(vkEndCommandBuffer(cmd))
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = nullptr;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+
+    VK_CHECK(vkQueueSubmit(_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE))
+
+    WaitForDevice();
+    vkFreeCommandBuffers(_device, _commandPool, 1, &cmd);
+
+    auto releases = std::move(_batchReleases);
+    _batchReleases.clear();
+
+    for (auto& release : releases)
+        release();
+}
+
+void VulkanDevice::ReleaseAfterSubmit(std::function<void()> release)
+{
+    if (_batch != VK_NULL_HANDLE)
+        _batchReleases.push_back(std::move(release));
+    else
+        release();
 }
 
 void VulkanDevice::WaitForDevice()
@@ -306,7 +381,12 @@ void VulkanDevice::CreateDevice()
     // In the event that we use compute, this needs to be upgraded.
     queueCreateInfos.resize(GetAreQueuesSame() ? 1 : 2);
 
-    const VkPhysicalDeviceFeatures features = {};
+    // Baked textures may be block compressed, every desktop GPU supports BC.
+    VkPhysicalDeviceFeatures supportedFeatures = {};
+    vkGetPhysicalDeviceFeatures(_physicalDevice->Get(), &supportedFeatures);
+
+    VkPhysicalDeviceFeatures features = {};
+    features.textureCompressionBC = supportedFeatures.textureCompressionBC;
 
     VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamicStateFeatures = {};
     dynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
@@ -41,7 +41,20 @@ public:
     VkDevice Get() const; /** @brief Returns the underlying Vulkan device. */
     VkCommandPool GetCommandPool() const; /** @brief Returns the default Vulkan command pool. */
     VmaAllocator GetAllocator() const; /** @brief Returns the Vulkan Memory Allocator object. */
-    void ImmediateSubmit(const std::function<void(VkCommandBuffer)>& recorder); /** @brief Submits commands to the graphics queue on the double. */
+    void ImmediateSubmit(const std::function<void(VkCommandBuffer)>& recorder); /** @brief Submits commands to the graphics queue on the double, inside a batch they're only recorded. */
+
+    /// @brief Records every ImmediateSubmit until EndSubmitBatch into one command buffer.
+    ///
+    /// Loads finished in the same frame then cost one submission and one wait instead of
+    /// one for every upload. Batches nest, only the outermost one submits.
+    void BeginSubmitBatch();
+
+    /// @brief Submits the batch, waits for it and runs everything passed to ReleaseAfterSubmit.
+    void EndSubmitBatch();
+
+    /// @brief Keeps whatever the recorded commands read from, usually a staging buffer, alive
+    /// until they've run. Outside a batch they already have and it's released right away.
+    void ReleaseAfterSubmit(std::function<void()> release);
 
     /// @brief Waits for an undefined amount of time for the device to finish whatever it may be doing.
     void WaitForDevice();
@@ -65,6 +78,9 @@ private:
     VmaAllocator _allocator;
     VulkanDescriptorSetLayoutCache _descriptorSetLayoutCache;
     VulkanPipelineLayoutCache _pipelineLayoutCache;
+    VkCommandBuffer _batch; /** @brief Recording the current batch, null outside of one. */
+    uint32_t _batchDepth;
+    std::vector<std::function<void()>> _batchReleases;
 };
 
 } // namespace bl
@@ -118,6 +118,7 @@ VulkanImage& VulkanImage::operator=(VulkanImage&& rhs) {
     _usage = rhs._usage;
     _aspectMask = rhs._aspectMask;
     _mipLevels = rhs._mipLevels;
+    _layout = rhs._layout;
     _image = rhs._image;
     _imageView = rhs._imageView;
     _allocation = rhs._allocation;
@@ -129,6 +130,7 @@ VulkanImage& VulkanImage::operator=(VulkanImage&& rhs) {
     rhs._usage = {};
     rhs._aspectMask = {};
     rhs._mipLevels = {};
+    rhs._layout = {};
     rhs._image = {};
     rhs._imageView = {};
     rhs._allocation = {};
@@ -156,6 +158,10 @@ VkImage VulkanImage::Get() const {
     return _image;
 }
 
+uint32_t VulkanImage::GetMipLevels() const {
+    return _mipLevels;
+}
+
 VkImageView VulkanImage::GetView() const {
     return _imageView;
 }
@@ -165,35 +171,52 @@ void VulkanImage::Destroy() {
 
     vkDestroyImageView(_device->Get(), _imageView, nullptr);
     vmaDestroyImage(_device->GetAllocator(), _image, _allocation);
+    _device = nullptr;
+    _layout = VK_IMAGE_LAYOUT_UNDEFINED;
 }
 
 void VulkanImage::UploadData(std::span<const std::byte> data, VkImageLayout finalLayout) {
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = _extent;
+
+    UploadData(data, std::span{&region, 1}, finalLayout);
+}
+
+void VulkanImage::UploadData(std::span<const std::byte> data, std::span<const VkBufferImageCopy> regions, VkImageLayout finalLayout) {
+    UploadData((VkDeviceSize)data.size(), regions, [&](std::span<std::byte> staging){
+        std::memcpy(staging.data(), data.data(), data.size());
+    }, finalLayout);
+}
+
+void VulkanImage::UploadData(VkDeviceSize size, std::span<const VkBufferImageCopy> regions, const std::function<void(std::span<std::byte>)>& write, VkImageLayout finalLayout) {
 
     // Create a staging buffer.
     VmaAllocationInfo allocInfo = {};
-    VulkanBuffer stagingBuffer{_device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, (VkDeviceSize)data.size(), &allocInfo, true};
+    VulkanBuffer stagingBuffer{_device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, size, &allocInfo, true};
 
-    // Copy image memory to the staging buffer.
-    std::memcpy(allocInfo.pMappedData, data.data(), data.size());
+    // Fill the staging buffer with the image memory.
+    write(std::span<std::byte>{static_cast<std::byte*>(allocInfo.pMappedData), (std::size_t)size});
 
+    UploadData(std::move(stagingBuffer), regions, finalLayout);
+}
+
+void VulkanImage::UploadData(VulkanBuffer&& staging, std::span<const VkBufferImageCopy> regions, VkImageLayout finalLayout) {
     _device->ImmediateSubmit([&](VkCommandBuffer cmd){
         Transition(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = _extent;
-
-        vkCmdCopyBufferToImage(cmd, stagingBuffer.Get(), _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
+        vkCmdCopyBufferToImage(cmd, staging.Get(), _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
         Transition(cmd, finalLayout);
     });
+
+    // Inside a submit batch the copy hasn't run yet.
+    _device->ReleaseAfterSubmit([buffer = std::make_shared<VulkanBuffer>(std::move(staging))]() mutable { buffer.reset(); });
 }
 
 void VulkanImage::Transition(VkCommandBuffer cmd, VkImageLayout layout) {
@@ -227,7 +250,7 @@ void VulkanImage::Transition(VkCommandBuffer cmd, VkImageLayout layout) {
     barrier.image = _image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = _mipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
@@ -4,6 +4,8 @@
 
 namespace bl {
 
+class VulkanBuffer;
+
 /// @brief Creates a graphics image on the physical device.
 class VulkanImage {
 public:
@@ -65,6 +67,10 @@ public:
     /// @return Returns the underlying Vulkan image from construction.
     VkImage Get() const;
 
+    /// @brief GetMipLevels
+    /// @return Returns the number of mip levels the image was created with.
+    uint32_t GetMipLevels() const;
+
     /// @brief GetView
     /// @return Returns the default image view created at construction.
     VkImageView GetView() const;
@@ -77,6 +83,22 @@ public:
     /// @param data The data to upload to the GPU. 
     void UploadData(std::span<const std::byte> data, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
+    /// @brief Uploads several regions, mip levels for example, through one staging buffer.
+    /// @param data Everything to upload, copied to the staging buffer in one go.
+    /// @param regions Where each part of the data goes, buffer offsets are relative to the start of data.
+    void UploadData(std::span<const std::byte> data, std::span<const VkBufferImageCopy> regions, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /// @brief Uploads several regions through one staging buffer the caller writes in place.
+    /// @param size Size of the staging buffer in bytes.
+    /// @param regions Where each part of the staging buffer goes.
+    /// @param write Fills the mapped staging buffer before the copy is submitted, decoders write into it directly.
+    void UploadData(VkDeviceSize size, std::span<const VkBufferImageCopy> regions, const std::function<void(std::span<std::byte>)>& write, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /// @brief Uploads several regions from a staging buffer filled ahead of time, on a loader thread for example.
+    /// @param staging Host visible buffer holding the data, kept alive until the copy has run.
+    /// @param regions Where each part of the staging buffer goes.
+    void UploadData(VulkanBuffer&& staging, std::span<const VkBufferImageCopy> regions, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
     /// @brief Transitions the image from the previous layout to another new one.
     /// @param cmd Command buffer to write the image transition command to.
     /// @param layout[in] New layout to transition the image into.
@@ -10,32 +10,16 @@ namespace bl
 VulkanMaterial::VulkanMaterial(VulkanDevice* device, VkRenderPass pass, uint32_t subpass, const VulkanPipelineStateInfo& state, uint32_t imageCount, uint32_t materialSet)
     : VulkanMaterialInstance(device, this)
     , _imageCount(imageCount)
+    , _device(device)
+    , _state(state)
+    , _pass(pass)
+    , _subpass(subpass)
     , _descriptorSetCache(device, 1024, VulkanDescriptorRatio::Default()) 
 {
     _materialSet = materialSet;
 
-    // Preform reflection on the pipeline shaders to retrieve detailed descriptor set info.
-    VulkanReflectedPipeline reflection = {state.stages};
-
-    auto& sets = reflection.GetReflectedDescriptorSets();
-    if (!sets.contains(materialSet))
-        throw std::runtime_error("VulkanMaterial does not contain the used set!");
-
-    auto& meta = sets.at(materialSet);
-
-    // Ensure that all uniform buffers are actually dynamic uniform buffers.
-    // This allows for us to use one buffer and swap between areas of it.
-    auto& bindings = meta.GetBindings();
-
-    for (auto& pair : bindings) 
-    {
-        auto binding = pair.second.GetBinding();
-
-        if (binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) 
-        {
-            pair.second.SetType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
-        }
-    }
+    VulkanReflectedPipeline reflection = Reflect(state, materialSet);
+    auto& meta = reflection.GetReflectedDescriptorSets().at(materialSet);
 
     // Construct the pipeline.
     _pipeline = std::make_unique<VulkanPipeline>(device, state, pass, subpass, &reflection);
@@ -76,4 +60,53 @@ VulkanMaterial::~VulkanMaterial()
 {
 }
 
+VulkanReflectedPipeline VulkanMaterial::Reflect(const VulkanPipelineStateInfo& state, uint32_t materialSet)
+{
+    // Preform reflection on the pipeline shaders to retrieve detailed descriptor set info.
+    VulkanReflectedPipeline reflection = {state.stages};
+
+    auto& sets = reflection.GetReflectedDescriptorSets();
+    if (!sets.contains(materialSet))
+        throw std::runtime_error("VulkanMaterial does not contain the used set!");
+
+    // Ensure that all uniform buffers are actually dynamic uniform buffers.
+    // This allows for us to use one buffer and swap between areas of it.
+    auto& bindings = sets.at(materialSet).GetBindings();
+
+    for (auto& pair : bindings) 
+    {
+        auto binding = pair.second.GetBinding();
+
+        if (binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) 
+        {
+            pair.second.SetType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+        }
+    }
+
+    return reflection;
+}
+
+bool VulkanMaterial::UsesShader(const VulkanShader* shader) const
+{
+    for (const auto& stage : _state.stages.shaders)
+    {
+        if (stage.Get() == shader)
+            return true;
+    }
+
+    return false;
+}
+
+void VulkanMaterial::RebuildPipeline()
+{
+    VulkanReflectedPipeline reflection = Reflect(_state, _materialSet);
+    auto pipeline = std::make_unique<VulkanPipeline>(_device, _state, _pass, _subpass, &reflection);
+
+    // Layouts come from the device's cache, the same bindings give back the same layout.
+    if (pipeline->GetDescriptorSetLayouts().at(_materialSet) != _layout)
+        throw std::runtime_error("Could not rebuild the material's pipeline, its shaders changed the material's bindings.");
+
+    _pipeline = std::move(pipeline);
+}
+
 } // namespace bl
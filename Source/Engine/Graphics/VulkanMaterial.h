@@ -56,6 +56,15 @@ public:
 
     VulkanMaterialInstance* CreateInstance();
 
+    bool UsesShader(const VulkanShader* shader) const; /** @brief Whether the shader is one of the pipeline's stages. */
+
+    /// @brief Recreates the pipeline from its shader modules as they are now, after one was hot reloaded.
+    ///
+    /// The device must be idle, see ResourceManager::PollHotReload. The material's set
+    /// layout is kept so instances and their bindings stay valid, a shader whose material
+    /// bindings changed throws and leaves the old pipeline in place.
+    void RebuildPipeline();
+
     void SetRasterizerState();
 
     // Allows you to change recompilable options of the pipeline.
@@ -63,11 +72,17 @@ public:
 private:
     friend class VulkanMaterialInstance;
 
+    /** @brief Reflects the stages with the material set's uniform buffers made dynamic. */
+    static VulkanReflectedPipeline Reflect(const VulkanPipelineStateInfo& state, uint32_t materialSet);
+
     std::map<std::string, VulkanVariableBlock> _uniforms; 
     std::map<std::string, uint32_t> _samplers; /** @brief Name -> Binding */
     uint32_t _imageCount;
     VkDescriptorSetLayout _layout;
     VulkanDevice* _device;
+    VulkanPipelineStateInfo _state; /** @brief Kept to rebuild the pipeline with. */
+    VkRenderPass _pass;
+    uint32_t _subpass;
     std::unique_ptr<VulkanPipeline> _pipeline;
     VulkanDescriptorSetAllocatorCache _descriptorSetCache;
 };
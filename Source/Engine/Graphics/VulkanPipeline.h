@@ -25,6 +25,13 @@ struct VulkanPipelineStateInfo {
         std::vector<VkVertexInputAttributeDescription> inputAttribs = Vertex::GetBindingAttributeDescriptions();
         VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         bool primitiveRestartEnable = VK_FALSE;
+
+        /** @brief Fetches vertices in a baked mesh's layout, see StaticModel::GetVertexFormat. */
+        void SetVertexFormat(VertexFormat format) {
+            bool compact = format == VertexFormat::eCompact;
+            inputBindings = compact ? CompactVertex::GetBindingDescriptions() : Vertex::GetBindingDescriptions();
+            inputAttribs = compact ? CompactVertex::GetBindingAttributeDescriptions() : Vertex::GetBindingAttributeDescriptions();
+        }
     } vertexState;
 
     struct RasterizerState {
@@ -22,7 +22,7 @@ public:
         VkBool32 compareEnable = VK_FALSE,
         VkCompareOp compareOp = VK_COMPARE_OP_NEVER,
         float minLod = 0.0f,
-        float maxLod = 0.0f,
+        float maxLod = VK_LOD_CLAMP_NONE,
         VkBorderColor borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
         VkBool32 unnormalizedCoordinates = VK_FALSE);
     ~VulkanSampler();
@@ -35,19 +35,19 @@ VulkanShader::~VulkanShader()
 
 void VulkanShader::Load() 
 {
-    // Load the shader binary into memory.
-    std::ifstream file(GetPath(), std::ios::ate | std::ios::binary);
-
-    if (!file.is_open()) {
-        throw std::runtime_error("failed to open file!");
-    }
+    LoadData();
+    FinishLoad();
+}
 
-    size_t fileSize = (size_t) file.tellg();
-    std::vector<char> buffer(fileSize);
+void VulkanShader::LoadData() 
+{
+    // Load the shader binary, packs keep payloads aligned so it can be used in place.
+    auto data = ReadData();
+    auto buffer = data.GetSpan();
 
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-    file.close();
+    if (buffer.empty() || buffer.size() % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("Shader binary is not valid SPIR-V!");
+    }
 
     // Create the reflection module for pipeline usage.
     if (spvReflectCreateShaderModule(buffer.size(), buffer.data(), &_reflect) != SPV_REFLECT_RESULT_SUCCESS) 
@@ -64,6 +64,10 @@ void VulkanShader::Load()
     moduleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(buffer.data());
 
     VK_CHECK(vkCreateShaderModule(_device->Get(), &moduleCreateInfo, nullptr, &_module))
+}
+
+void VulkanShader::FinishLoad() 
+{
     Resource::Load();
 }
 
@@ -73,6 +77,7 @@ void VulkanShader::Unload()
 
     vkDestroyShaderModule(_device->Get(), _module, nullptr); 
     spvReflectDestroyShaderModule(&_reflect);
+    _module = VK_NULL_HANDLE;
     Resource::Unload();
 }
 
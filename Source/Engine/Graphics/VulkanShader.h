@@ -16,6 +16,8 @@ public:
 
     virtual void Load() override;
     virtual void Unload() override;
+    virtual void LoadData() override; /** @brief Reflects and creates the module, neither needs the render thread. */
+    virtual void FinishLoad() override;
 
     VkShaderStageFlagBits GetStage() const; /** @brief Returns the shader stage created with. */
     const SpvReflectShaderModule& GetReflection() const; /** @brief Returns the reflection module. */
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Math.h"
+
+namespace bl
+{
+
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes; /** @brief Left, right, bottom, top, near, far. xyz is the inward normal, w the distance. */
+
+    /** @brief Extracts the planes of a Vulkan style projection, depth from zero to one. */
+    static Frustum FromMatrix(const glm::mat4& viewProjection)
+    {
+        auto row = [&](int i){ return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]}; };
+
+        Frustum frustum;
+        frustum.planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+
+        for (auto& plane : frustum.planes)
+            plane /= glm::length(glm::vec3{plane});
+
+        return frustum;
+    }
+
+    /** @brief Returns false when a sphere is entirely outside of any plane. */
+    bool IntersectsSphere(glm::vec3 center, float radius) const
+    {
+        for (const auto& plane : planes)
+        {
+            if (glm::dot(glm::vec3{plane}, center) + plane.w < -radius)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+} // namespace bl
@@ -0,0 +1,63 @@
+#include "AsyncLoad.h"
+
+namespace bl
+{
+
+AsyncLoad::AsyncLoad(Resource* resource)
+    : _resource(resource)
+    , _state(AsyncLoadState::eQueued)
+    , _cancelled(false)
+{
+}
+
+AsyncLoadState AsyncLoad::GetState() const
+{
+    return _state;
+}
+
+bool AsyncLoad::IsDone() const
+{
+    auto state = GetState();
+    return state == AsyncLoadState::eLoaded || state == AsyncLoadState::eFailed || state == AsyncLoadState::eCancelled;
+}
+
+Resource* AsyncLoad::GetResource() const
+{
+    return _resource.Get();
+}
+
+const std::string& AsyncLoad::GetError() const
+{
+    static const std::string none;
+    return GetState() == AsyncLoadState::eFailed ? _error : none;
+}
+
+void AsyncLoad::Cancel()
+{
+    if (!IsDone())
+        _cancelled = true;
+}
+
+void AsyncLoad::AddReadyCallback(std::function<void(Resource*)> callback)
+{
+    if (GetState() == AsyncLoadState::eLoaded)
+        callback(_resource.Get());
+    else if (!IsDone())
+        _callbacks.push_back(std::move(callback));
+}
+
+void AsyncLoad::SetLoaded()
+{
+    if (GetState() != AsyncLoadState::eFinishing)
+        return;
+
+    _state = AsyncLoadState::eLoaded;
+
+    auto callbacks = std::move(_callbacks);
+    _callbacks.clear();
+
+    for (const auto& callback : callbacks)
+        callback(_resource.Get());
+}
+
+} // namespace bl
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Resource.h"
+
+#include <atomic>
+
+namespace bl
+{
+
+/** @brief Where an asynchronous load is at, see ResourceManager::LoadAsync. */
+enum class AsyncLoadState
+{
+    eQueued, /** @brief Waiting for a loader thread. */
+    eReading, /** @brief Reading and decoding on a loader thread, see Resource::LoadData. */
+    eFinishing, /** @brief Read, waiting for ResourceManager::FinishLoads to upload it on the render thread. */
+    eLoaded,
+    eFailed, /** @brief Reading or finishing threw, GetError says why. */
+    eCancelled,
+};
+
+/// @brief The state every handle to one load shares.
+///
+/// The state can be polled from any thread, everything else belongs to the render
+/// thread. Loads of the same resource in flight at the same time share one of these,
+/// so cancelling it cancels the load for every handle to it. It holds a reference to
+/// the resource, nothing evicts a resource while a handle to its load is around.
+class AsyncLoad
+{
+public:
+    AsyncLoad(Resource* resource);
+
+    AsyncLoadState GetState() const;
+    bool IsDone() const; /** @brief Loaded, failed or cancelled, the state won't change anymore. */
+    Resource* GetResource() const;
+    const std::string& GetError() const; /** @brief Why the load failed, empty unless it did. */
+    void Cancel(); /** @brief Stops the load before it's finished, the resource is unloaded again. Does nothing once it's done. */
+    void AddReadyCallback(std::function<void(Resource*)> callback); /** @brief Called on the render thread once loaded, right away if it already is. */
+
+private:
+    friend class ResourceManager;
+
+    void SetLoaded(); /** @brief Once finished, marks a load that didn't fail or get cancelled as loaded and calls its callbacks. */
+
+    ResourceRef<Resource> _resource;
+    std::atomic<AsyncLoadState> _state;
+    std::atomic<bool> _cancelled;
+    std::string _error;
+    std::shared_future<void> _read; /** @brief Done once the loader thread is, a blocking Load() of the resource waits on it. */
+    std::shared_future<void> _batch; /** @brief The batched read of the resource's loose file, if it's in one, see ResourceManager::ReadBatch. */
+    std::vector<std::shared_ptr<AsyncLoad>> _dependencies; /** @brief Loads in flight that have to finish before this one, it fails if any of them do. */
+    std::vector<std::function<void(Resource*)>> _callbacks;
+};
+
+/// @brief A typed handle to a load started with ResourceManager::LoadAsync.
+///
+/// Cheap to copy, copies share the load. A default constructed handle has nothing
+/// to load and reports itself as cancelled.
+template<typename T>
+class AsyncLoadHandle
+{
+public:
+    AsyncLoadHandle() = default;
+    explicit AsyncLoadHandle(std::shared_ptr<AsyncLoad> load);
+
+    AsyncLoadState GetState() const;
+    bool IsReady() const; /** @brief True once the resource is loaded and Get() can be called. */
+    bool IsDone() const;
+    const std::string& GetError() const;
+    ResourceRef<T> Get() const; /** @brief Returns the loaded resource, throws if it isn't ready. */
+    void OnReady(std::function<void(T*)> callback) const; /** @brief Called on the render thread once loaded, never if the load fails or is cancelled. */
+    void Cancel() const;
+
+private:
+    std::shared_ptr<AsyncLoad> _load;
+};
+
+template<typename T>
+AsyncLoadHandle<T>::AsyncLoadHandle(std::shared_ptr<AsyncLoad> load)
+    : _load(std::move(load))
+{
+}
+
+template<typename T>
+AsyncLoadState AsyncLoadHandle<T>::GetState() const
+{
+    return _load ? _load->GetState() : AsyncLoadState::eCancelled;
+}
+
+template<typename T>
+bool AsyncLoadHandle<T>::IsReady() const
+{
+    return GetState() == AsyncLoadState::eLoaded;
+}
+
+template<typename T>
+bool AsyncLoadHandle<T>::IsDone() const
+{
+    return !_load || _load->IsDone();
+}
+
+template<typename T>
+const std::string& AsyncLoadHandle<T>::GetError() const
+{
+    static const std::string none;
+    return _load ? _load->GetError() : none;
+}
+
+template<typename T>
+ResourceRef<T> AsyncLoadHandle<T>::Get() const
+{
+    if (!IsReady())
+    {
+        throw std::runtime_error("Could not get a resource that hasn't finished loading!");
+    }
+
+    return ResourceRef<T>{static_cast<T*>(_load->GetResource())};
+}
+
+template<typename T>
+void AsyncLoadHandle<T>::OnReady(std::function<void(T*)> callback) const
+{
+    if (!_load)
+        return;
+
+    _load->AddReadyCallback([callback = std::move(callback)](Resource* resource){
+        callback(static_cast<T*>(resource));
+    });
+}
+
+template<typename T>
+void AsyncLoadHandle<T>::Cancel() const
+{
+    if (_load)
+        _load->Cancel();
+}
+
+} // namespace bl
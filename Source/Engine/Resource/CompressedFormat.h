@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bl
+{
+
+// A compressed payload is a resource file split into fixed-size chunks, each compressed
+// on its own so they can all be decompressed at once on different threads, straight
+// into their part of the resource's bytes. Chunks that wouldn't get smaller are stored.
+// The same bytes are a pack payload, flagged with PackEntryCompressed, or a loose file
+// recognized by its magic. See Resource/Compression.h.
+//
+// Compressed (header)
+//  magic       (char[4]) 'B' 'C' 'M' 'P'
+//  version     (uint32_t) (1)
+//  codec       (uint32_t) CodecId of every compressed chunk.
+//  chunkSize   (uint32_t) Decompressed bytes in every chunk but the last.
+//  size        (uint64_t) Decompressed bytes in all.
+//  numChunks   (uint32_t)
+//  reserved    (uint32_t)
+//
+// Chunks (array, in order)
+//  CompressedChunk (sizeof(CompressedChunk) * numChunks)
+//
+// Data
+//  Each chunk's compressed bytes.
+
+constexpr uint32_t CompressedVersion = 1;
+
+enum class CodecId : uint32_t
+{
+    eZlib = 1,
+};
+
+enum CompressedChunkFlags : uint32_t
+{
+    CompressedChunkStored = 1 << 0, /** @brief Copied as is, it didn't compress. */
+};
+
+struct CompressedHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t codec;
+    uint32_t chunkSize;
+    uint64_t size;
+    uint32_t numChunks;
+    uint32_t reserved;
+};
+
+struct CompressedChunk
+{
+    uint64_t offset; /** @brief From the start of the payload. */
+    uint32_t size; /** @brief Compressed bytes. */
+    uint32_t flags;
+};
+
+static_assert(sizeof(CompressedHeader) == 32);
+static_assert(sizeof(CompressedChunk) == 16);
+
+} // namespace bl
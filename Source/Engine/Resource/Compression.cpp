@@ -0,0 +1,246 @@
+#include <cstring>
+
+#include <zlib.h>
+
+#include "Compression.h"
+
+namespace bl
+{
+
+static const CompressedHeader& GetHeader(std::span<const std::byte> data, std::span<const CompressedChunk>& chunks)
+{
+    if (!IsCompressed(data))
+        throw std::runtime_error("Compressed payload has an invalid header.");
+
+    const auto* header = reinterpret_cast<const CompressedHeader*>(data.data());
+
+    if (header->version != CompressedVersion)
+        throw std::runtime_error("Compressed payload has an unsupported version, it needs to be baked again.");
+
+    uint64_t numChunks = header->chunkSize > 0 ? (header->size + header->chunkSize - 1) / header->chunkSize : 0;
+    if (header->chunkSize == 0 || header->numChunks != numChunks)
+        throw std::runtime_error("Compressed payload has chunks that don't add up to its size.");
+
+    if ((uint64_t)header->numChunks * sizeof(CompressedChunk) > data.size() - sizeof(CompressedHeader))
+        throw std::runtime_error("Compressed payload chunk table is out of bounds.");
+
+    chunks = {reinterpret_cast<const CompressedChunk*>(data.data() + sizeof(CompressedHeader)), header->numChunks};
+
+    for (uint32_t i = 0; i < header->numChunks; i++)
+    {
+        const auto& chunk = chunks[i];
+        uint64_t size = std::min<uint64_t>(header->chunkSize, header->size - (uint64_t)i * header->chunkSize);
+
+        if (chunk.offset > data.size() || chunk.size > data.size() - chunk.offset)
+            throw std::runtime_error("Compressed payload chunk is out of bounds.");
+
+        if ((chunk.flags & CompressedChunkStored) && chunk.size != size)
+            throw std::runtime_error("Compressed payload has a stored chunk of the wrong size.");
+    }
+
+    return *header;
+}
+
+/** @brief Runs a function for every chunk, split into one run of chunks per thread with the calling thread taking the first. */
+static void ForEachChunk(uint32_t numChunks, ThreadPool* pool, const std::function<void(uint32_t)>& function)
+{
+    uint32_t numJobs = pool ? std::min(numChunks, pool->GetThreadCount() + 1) : 1;
+    if (numJobs <= 1)
+    {
+        for (uint32_t i = 0; i < numChunks; i++)
+            function(i);
+
+        return;
+    }
+
+    auto run = [&](uint32_t job){
+        for (auto i = (uint32_t)((uint64_t)numChunks * job / numJobs); i < (uint64_t)numChunks * (job + 1) / numJobs; i++)
+            function(i);
+    };
+
+    std::vector<std::future<void>> jobs;
+    for (uint32_t job = 1; job < numJobs; job++)
+        jobs.push_back(pool->Submit([&run, job](){ run(job); }));
+
+    // Every job has to be done with the buffers before anything is thrown.
+    std::exception_ptr error;
+    try
+    {
+        run(0);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    for (auto& job : jobs)
+    {
+        try
+        {
+            job.get();
+        }
+        catch (...)
+        {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+CodecId ZlibCodec::GetId() const
+{
+    return CodecId::eZlib;
+}
+
+const char* ZlibCodec::GetName() const
+{
+    return "zlib";
+}
+
+std::size_t ZlibCodec::GetCompressBound(std::size_t size) const
+{
+    return compressBound((uLong)size);
+}
+
+std::size_t ZlibCodec::Compress(std::span<const std::byte> source, std::span<std::byte> destination) const
+{
+    uLongf size = (uLongf)destination.size();
+    int result = compress2(reinterpret_cast<Bytef*>(destination.data()), &size, reinterpret_cast<const Bytef*>(source.data()), (uLong)source.size(), Z_BEST_COMPRESSION);
+
+    if (result != Z_OK)
+        throw std::runtime_error("Could not compress a chunk with zlib, error " + std::to_string(result) + ".");
+
+    return size;
+}
+
+void ZlibCodec::Decompress(std::span<const std::byte> source, std::span<std::byte> destination) const
+{
+    uLongf size = (uLongf)destination.size();
+    int result = uncompress(reinterpret_cast<Bytef*>(destination.data()), &size, reinterpret_cast<const Bytef*>(source.data()), (uLong)source.size());
+
+    if (result != Z_OK || size != destination.size())
+        throw std::runtime_error("Could not decompress a zlib chunk, it's corrupt.");
+}
+
+const Codec& GetCodec(CodecId id)
+{
+    static const ZlibCodec zlib;
+
+    switch (id)
+    {
+    case CodecId::eZlib: return zlib;
+    default: throw std::runtime_error("Could not find compression codec " + std::to_string((uint32_t)id) + ".");
+    }
+}
+
+const Codec& GetCodec(std::string_view name)
+{
+    for (auto id : {CodecId::eZlib})
+    {
+        const auto& codec = GetCodec(id);
+        if (name == codec.GetName())
+            return codec;
+    }
+
+    throw std::runtime_error("Could not find compression codec " + std::string{name} + ".");
+}
+
+bool IsCompressed(std::span<const std::byte> data)
+{
+    return data.size() >= sizeof(CompressedHeader) && std::memcmp(data.data(), "BCMP", 4) == 0;
+}
+
+uint64_t GetDecompressedSize(std::span<const std::byte> data)
+{
+    std::span<const CompressedChunk> chunks;
+    return GetHeader(data, chunks).size;
+}
+
+std::vector<std::byte> Compress(std::span<const std::byte> data, const Codec& codec, uint32_t chunkSize, ThreadPool* pool)
+{
+    if (chunkSize == 0)
+        throw std::runtime_error("Could not compress with chunks of zero bytes.");
+
+    uint32_t numChunks = (uint32_t)((data.size() + chunkSize - 1) / chunkSize);
+
+    // Each chunk compresses into its own buffer, they're only laid out once their sizes are known.
+    std::vector<std::vector<std::byte>> compressed(numChunks);
+    ForEachChunk(numChunks, pool, [&](uint32_t i){
+        auto source = data.subspan((size_t)i * chunkSize, std::min<size_t>(chunkSize, data.size() - (size_t)i * chunkSize));
+
+        auto& out = compressed[i];
+        out.resize(codec.GetCompressBound(source.size()));
+        out.resize(codec.Compress(source, out));
+
+        if (out.size() >= source.size())
+            out.clear();
+    });
+
+    CompressedHeader header{};
+    std::memcpy(header.magic, "BCMP", 4);
+    header.version = CompressedVersion;
+    header.codec = (uint32_t)codec.GetId();
+    header.chunkSize = chunkSize;
+    header.size = data.size();
+    header.numChunks = numChunks;
+
+    std::vector<CompressedChunk> chunks(numChunks);
+    uint64_t offset = sizeof(CompressedHeader) + numChunks * sizeof(CompressedChunk);
+
+    for (uint32_t i = 0; i < numChunks; i++)
+    {
+        bool stored = compressed[i].empty();
+        chunks[i].offset = offset;
+        chunks[i].size = stored ? (uint32_t)std::min<size_t>(chunkSize, data.size() - (size_t)i * chunkSize) : (uint32_t)compressed[i].size();
+        chunks[i].flags = stored ? CompressedChunkStored : 0;
+        offset += chunks[i].size;
+    }
+
+    std::vector<std::byte> out(offset);
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), chunks.data(), chunks.size() * sizeof(CompressedChunk));
+
+    for (uint32_t i = 0; i < numChunks; i++)
+    {
+        if (chunks[i].flags & CompressedChunkStored)
+            std::memcpy(out.data() + chunks[i].offset, data.data() + (size_t)i * chunkSize, chunks[i].size);
+        else
+            std::memcpy(out.data() + chunks[i].offset, compressed[i].data(), chunks[i].size);
+    }
+
+    return out;
+}
+
+void Decompress(std::span<const std::byte> data, std::span<std::byte> destination, ThreadPool* pool)
+{
+    std::span<const CompressedChunk> chunks;
+    const auto& header = GetHeader(data, chunks);
+
+    if (destination.size() != header.size)
+        throw std::runtime_error("Could not decompress a payload into a buffer of the wrong size.");
+
+    const auto& codec = GetCodec((CodecId)header.codec);
+
+    ForEachChunk(header.numChunks, pool, [&](uint32_t i){
+        const auto& chunk = chunks[i];
+        auto source = data.subspan(chunk.offset, chunk.size);
+        auto target = destination.subspan((size_t)i * header.chunkSize, std::min<size_t>(header.chunkSize, header.size - (size_t)i * header.chunkSize));
+
+        if (chunk.flags & CompressedChunkStored)
+            std::memcpy(target.data(), source.data(), source.size());
+        else
+            codec.Decompress(source, target);
+    });
+}
+
+std::vector<std::byte> Decompress(std::span<const std::byte> data, ThreadPool* pool)
+{
+    std::vector<std::byte> out(GetDecompressedSize(data));
+    Decompress(data, out, pool);
+    return out;
+}
+
+} // namespace bl
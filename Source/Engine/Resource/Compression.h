@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+#include "Core/ThreadPool.h"
+#include "CompressedFormat.h"
+
+namespace bl
+{
+
+constexpr uint32_t DefaultChunkSize = 256 * 1024; /** @brief Small enough to split a texture across every core, large enough to compress well. */
+
+/// @brief Compresses and decompresses the chunks of a compressed payload, see Resource/CompressedFormat.h.
+///
+/// Faster codecs are added by implementing this and listing them in GetCodec. Every
+/// method may be called from several threads at once.
+class Codec : public NonCopyable
+{
+public:
+    virtual ~Codec() = default;
+
+    virtual CodecId GetId() const = 0;
+    virtual const char* GetName() const = 0;
+    virtual std::size_t GetCompressBound(std::size_t size) const = 0; /** @brief Most bytes Compress may write for a chunk of this size. */
+
+    /// @brief Compresses a chunk, throws on failure.
+    /// @returns The number of bytes written to the destination.
+    virtual std::size_t Compress(std::span<const std::byte> source, std::span<std::byte> destination) const = 0;
+
+    /// @brief Decompresses a chunk, throws unless it fills the destination exactly.
+    virtual void Decompress(std::span<const std::byte> source, std::span<std::byte> destination) const = 0;
+};
+
+/** @brief The vendored zlib at its best compression, payloads are baked once and read many times. */
+class ZlibCodec : public Codec
+{
+public:
+    CodecId GetId() const override;
+    const char* GetName() const override;
+    std::size_t GetCompressBound(std::size_t size) const override;
+    std::size_t Compress(std::span<const std::byte> source, std::span<std::byte> destination) const override;
+    void Decompress(std::span<const std::byte> source, std::span<std::byte> destination) const override;
+};
+
+const Codec& GetCodec(CodecId id); /** @brief Throws for a codec this build doesn't have. */
+const Codec& GetCodec(std::string_view name); /** @brief By the codec's name, as the asset processor is given it. */
+
+bool IsCompressed(std::span<const std::byte> data); /** @brief Whether the bytes start like a compressed payload. */
+uint64_t GetDecompressedSize(std::span<const std::byte> data); /** @brief Throws if the bytes aren't a valid compressed payload. */
+
+/// @brief Splits bytes into chunks and compresses each on its own.
+/// @param[in] pool Compresses the chunks in parallel, on this thread if null.
+std::vector<std::byte> Compress(std::span<const std::byte> data, const Codec& codec, uint32_t chunkSize = DefaultChunkSize, ThreadPool* pool = nullptr);
+
+/// @brief Decompresses every chunk straight into its part of the destination, throws if the payload is malformed.
+///
+/// The calling thread decompresses its share too, so this must not be called from a
+/// job of the same pool.
+/// @param[in] destination Exactly GetDecompressedSize bytes.
+/// @param[in] pool Decompresses the chunks in parallel, on this thread if null.
+void Decompress(std::span<const std::byte> data, std::span<std::byte> destination, ThreadPool* pool = nullptr);
+std::vector<std::byte> Decompress(std::span<const std::byte> data, ThreadPool* pool = nullptr);
+
+} // namespace bl
@@ -0,0 +1,465 @@
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#include "Core/Platform.h"
+#include "Core/Print.h"
+#include "FileSystem.h"
+
+#if defined(BLUEMETAL_SYSTEM_LINUX)
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace bl
+{
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::byte> ReadWholeFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open a file to read: " + path.string());
+
+    std::vector<std::byte> bytes(std::filesystem::file_size(path));
+    file.read(reinterpret_cast<char*>(bytes.data()), (std::streamsize)bytes.size());
+
+    if (!file)
+        throw std::runtime_error("Could not read a file: " + path.string());
+
+    return bytes;
+}
+
+std::chrono::nanoseconds FileSystemStats::GetAverageLatency() const
+{
+    return reads > 0 ? totalLatency / (int64_t)reads : std::chrono::nanoseconds{0};
+}
+
+double FileSystemStats::GetThroughput() const
+{
+    double seconds = std::chrono::duration<double>(totalLatency).count();
+    return seconds > 0.0 ? (double)bytes / seconds : 0.0;
+}
+
+std::vector<ResourceData> FileSystem::ReadMany(std::span<const std::filesystem::path> paths)
+{
+    std::vector<ResourceData> data;
+    data.reserve(paths.size());
+
+    for (const auto& path : paths)
+        data.push_back(Read(path));
+
+    return data;
+}
+
+bool FileSystem::CanBatch() const
+{
+    return false;
+}
+
+FileSystemStats FileSystem::GetStats() const
+{
+    FileSystemStats stats;
+    stats.reads = _reads;
+    stats.bytes = _bytes;
+    stats.totalLatency = std::chrono::nanoseconds{_totalLatency.load()};
+    stats.maxLatency = std::chrono::nanoseconds{_maxLatency.load()};
+    return stats;
+}
+
+void FileSystem::ResetStats()
+{
+    _reads = 0;
+    _bytes = 0;
+    _totalLatency = 0;
+    _maxLatency = 0;
+}
+
+void FileSystem::CountRead(uint64_t bytes, std::chrono::nanoseconds latency)
+{
+    auto nanoseconds = (int64_t)latency.count();
+
+    _reads++;
+    _bytes += bytes;
+    _totalLatency += nanoseconds;
+
+    auto max = _maxLatency.load();
+    while (nanoseconds > max && !_maxLatency.compare_exchange_weak(max, nanoseconds));
+}
+
+const char* PlainFileSystem::GetName() const
+{
+    return "Plain";
+}
+
+ResourceData PlainFileSystem::Read(const std::filesystem::path& path, bool copy)
+{
+    (void)copy;
+
+    auto start = Clock::now();
+    auto bytes = ReadWholeFile(path);
+    CountRead(bytes.size(), Clock::now() - start);
+
+    return ResourceData{std::move(bytes)};
+}
+
+const char* MappedFileSystem::GetName() const
+{
+    return "Mapped";
+}
+
+ResourceData MappedFileSystem::Read(const std::filesystem::path& path, bool copy)
+{
+    auto start = Clock::now();
+
+    if (copy)
+    {
+        auto bytes = ReadWholeFile(path);
+        CountRead(bytes.size(), Clock::now() - start);
+        return ResourceData{std::move(bytes)};
+    }
+
+    auto file = std::make_shared<const MappedFile>(path);
+    CountRead(file->GetData().size(), Clock::now() - start);
+
+    return ResourceData{std::move(file)};
+}
+
+#if defined(BLUEMETAL_SYSTEM_LINUX)
+
+// Reads in flight per thread, a ReadMany of more files queues the rest behind them.
+static constexpr unsigned UringQueueDepth = 64;
+
+// A single read is limited to what fits in an int result, larger files take several.
+static constexpr uint64_t UringMaxReadSize = 1u << 30;
+
+/// @brief An io_uring set up through the raw system calls, nothing to link against.
+///
+/// Only used by the thread that made it. Submission and completion rings are shared
+/// with the kernel, their heads and tails are read and written with acquire and release.
+class UringRing : public NonCopyable
+{
+public:
+    UringRing(unsigned entries)
+    {
+        _fd = (int)syscall(__NR_io_uring_setup, entries, &_params);
+        if (_fd < 0)
+            return;
+
+        size_t sqSize = _params.sq_off.array + _params.sq_entries * sizeof(unsigned);
+        size_t cqSize = _params.cq_off.cqes + _params.cq_entries * sizeof(io_uring_cqe);
+
+        // Newer kernels map both rings at once.
+        if (_params.features & IORING_FEAT_SINGLE_MMAP)
+            sqSize = cqSize = std::max(sqSize, cqSize);
+
+        _sqSize = sqSize;
+        _cqSize = cqSize;
+        _sqesSize = _params.sq_entries * sizeof(io_uring_sqe);
+
+        _sq = mmap(nullptr, _sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+        _cq = (_params.features & IORING_FEAT_SINGLE_MMAP) ? _sq : mmap(nullptr, _cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        void* sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+
+        if (_sq == MAP_FAILED || _cq == MAP_FAILED || sqes == MAP_FAILED)
+        {
+            if (sqes != MAP_FAILED)
+                munmap(sqes, _sqesSize);
+
+            Close();
+            return;
+        }
+
+        auto* sq = static_cast<std::byte*>(_sq);
+        auto* cq = static_cast<std::byte*>(_cq);
+
+        _sqTail = reinterpret_cast<unsigned*>(sq + _params.sq_off.tail);
+        _sqMask = reinterpret_cast<unsigned*>(sq + _params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned*>(sq + _params.sq_off.array);
+        _sqes = static_cast<io_uring_sqe*>(sqes);
+
+        _cqHead = reinterpret_cast<unsigned*>(cq + _params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned*>(cq + _params.cq_off.tail);
+        _cqMask = reinterpret_cast<unsigned*>(cq + _params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe*>(cq + _params.cq_off.cqes);
+    }
+
+    ~UringRing()
+    {
+        if (_sqes)
+            munmap(_sqes, _sqesSize);
+
+        Close();
+    }
+
+    bool IsValid() const
+    {
+        return _fd >= 0;
+    }
+
+    unsigned GetCapacity() const
+    {
+        return _params.sq_entries;
+    }
+
+    /** @brief Queues a read, at most GetCapacity() may be queued or in flight at once. */
+    void Push(int fd, std::byte* buffer, unsigned size, uint64_t offset, uint64_t userData)
+    {
+        unsigned tail = *_sqTail;
+        unsigned index = tail & *_sqMask;
+
+        auto& sqe = _sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.user_data = userData;
+
+        _sqArray[index] = index;
+        __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+        _queued++;
+    }
+
+    /** @brief Submits everything queued and waits until at least one read completes. */
+    void SubmitAndWait()
+    {
+        while (true)
+        {
+            int result = (int)syscall(__NR_io_uring_enter, _fd, _queued, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0)
+            {
+                _queued -= std::min((unsigned)result, _queued);
+                return;
+            }
+
+            if (errno != EINTR && errno != EAGAIN)
+                throw std::runtime_error(std::string("Could not submit to io_uring: ") + std::strerror(errno));
+        }
+    }
+
+    bool Pop(io_uring_cqe& cqe)
+    {
+        unsigned head = *_cqHead;
+        if (head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE))
+            return false;
+
+        cqe = _cqes[head & *_cqMask];
+        __atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    void Close()
+    {
+        if (_cq != MAP_FAILED && _cq != _sq)
+            munmap(_cq, _cqSize);
+
+        if (_sq != MAP_FAILED)
+            munmap(_sq, _sqSize);
+
+        if (_fd >= 0)
+            close(_fd);
+
+        _sq = _cq = MAP_FAILED;
+        _fd = -1;
+    }
+
+    int _fd = -1;
+    io_uring_params _params{};
+    void* _sq = MAP_FAILED;
+    void* _cq = MAP_FAILED;
+    size_t _sqSize = 0;
+    size_t _cqSize = 0;
+    size_t _sqesSize = 0;
+    unsigned* _sqTail = nullptr;
+    unsigned* _sqMask = nullptr;
+    unsigned* _sqArray = nullptr;
+    io_uring_sqe* _sqes = nullptr;
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned* _cqMask = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+    unsigned _queued = 0;
+};
+
+static UringRing& GetThreadRing()
+{
+    thread_local UringRing ring{UringQueueDepth};
+    return ring;
+}
+
+UringFileSystem::UringFileSystem()
+{
+}
+
+std::vector<ResourceData> UringFileSystem::ReadMany(std::span<const std::filesystem::path> paths)
+{
+    auto& ring = GetThreadRing();
+    if (!ring.IsValid())
+    {
+        static std::once_flag warned;
+        std::call_once(warned, [](){ blWarning("io_uring isn't available, reading with std::ifstream instead."); });
+
+        std::vector<ResourceData> data;
+        for (const auto& path : paths)
+        {
+            auto start = Clock::now();
+            auto bytes = ReadWholeFile(path);
+            CountRead(bytes.size(), Clock::now() - start);
+            data.push_back(ResourceData{std::move(bytes)});
+        }
+
+        return data;
+    }
+
+    struct Request
+    {
+        int fd = -1;
+        std::vector<std::byte> bytes;
+        uint64_t done = 0;
+        Clock::time_point start;
+    };
+
+    std::vector<Request> requests(paths.size());
+    auto closeAll = [&](){
+        for (auto& request : requests)
+        {
+            if (request.fd >= 0)
+                close(request.fd);
+        }
+    };
+
+    std::deque<size_t> work;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        auto& request = requests[i];
+        request.start = Clock::now();
+        request.fd = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+
+        struct stat info{};
+        if (request.fd < 0 || fstat(request.fd, &info) != 0)
+        {
+            closeAll();
+            throw std::runtime_error("Could not open a file to read: " + paths[i].string());
+        }
+
+        request.bytes.resize((size_t)info.st_size);
+        if (request.bytes.empty())
+            CountRead(0, Clock::now() - request.start);
+        else
+            work.push_back(i);
+    }
+
+    // Short reads go back in the queue for the rest, a read that fails stops new ones
+    // but whatever's in flight still lands in its buffer before they're freed.
+    std::string error;
+    unsigned inFlight = 0;
+
+    while (inFlight > 0 || (!work.empty() && error.empty()))
+    {
+        while (inFlight < ring.GetCapacity() && !work.empty() && error.empty())
+        {
+            auto index = work.front();
+            work.pop_front();
+
+            auto& request = requests[index];
+            auto size = (unsigned)std::min<uint64_t>(request.bytes.size() - request.done, UringMaxReadSize);
+            ring.Push(request.fd, request.bytes.data() + request.done, size, request.done, index);
+            inFlight++;
+        }
+
+        ring.SubmitAndWait();
+
+        io_uring_cqe cqe;
+        while (ring.Pop(cqe))
+        {
+            inFlight--;
+
+            auto index = (size_t)cqe.user_data;
+            auto& request = requests[index];
+
+            if (cqe.res <= 0)
+            {
+                if (error.empty())
+                    error = "Could not read a file: " + paths[index].string() + (cqe.res < 0 ? std::string(", ") + std::strerror(-cqe.res) : std::string(", it ended early"));
+
+                continue;
+            }
+
+            request.done += (uint64_t)cqe.res;
+            if (request.done < request.bytes.size())
+                work.push_back(index);
+            else
+                CountRead(request.bytes.size(), Clock::now() - request.start);
+        }
+    }
+
+    closeAll();
+
+    if (!error.empty())
+        throw std::runtime_error(error);
+
+    std::vector<ResourceData> data;
+    data.reserve(requests.size());
+
+    for (auto& request : requests)
+        data.push_back(ResourceData{std::move(request.bytes)});
+
+    return data;
+}
+
+#else
+
+UringFileSystem::UringFileSystem()
+{
+    throw std::runtime_error("io_uring is only available on Linux.");
+}
+
+std::vector<ResourceData> UringFileSystem::ReadMany(std::span<const std::filesystem::path> paths)
+{
+    (void)paths;
+    throw std::runtime_error("io_uring is only available on Linux.");
+}
+
+#endif
+
+const char* UringFileSystem::GetName() const
+{
+    return "Uring";
+}
+
+bool UringFileSystem::CanBatch() const
+{
+    return true;
+}
+
+ResourceData UringFileSystem::Read(const std::filesystem::path& path, bool copy)
+{
+    (void)copy;
+
+    auto data = ReadMany({&path, 1});
+    return std::move(data[0]);
+}
+
+std::unique_ptr<FileSystem> CreateFileSystem(std::string_view name)
+{
+    if (name == "Plain")
+        return std::make_unique<PlainFileSystem>();
+
+    if (name == "Mapped")
+        return std::make_unique<MappedFileSystem>();
+
+    if (name == "Uring")
+        return std::make_unique<UringFileSystem>();
+
+    throw std::runtime_error("Unknown file system " + std::string{name} + ", expected Plain, Mapped or Uring.");
+}
+
+} // namespace bl
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+#include "ResourceData.h"
+
+#include <atomic>
+
+namespace bl
+{
+
+/** @brief What a file system read since it was made or last reset. */
+struct FileSystemStats
+{
+    uint64_t reads = 0;
+    uint64_t bytes = 0;
+    std::chrono::nanoseconds totalLatency{0}; /** @brief Summed over every read, reads on different threads overlap. */
+    std::chrono::nanoseconds maxLatency{0};
+
+    std::chrono::nanoseconds GetAverageLatency() const;
+    double GetThroughput() const; /** @brief Bytes per second of a single read, bytes over the total latency. */
+};
+
+/// @brief Where the resource manager reads loose files and manifests from, see ResourceManager::SetFileSystem.
+///
+/// Backends only differ in how they read a whole file, so the fastest one for a
+/// deployment can be picked and measured. Each counts its reads the same way, from
+/// asking for a file to having its bytes. Reads come from several loader threads at once.
+class FileSystem : public NonCopyable
+{
+public:
+    virtual ~FileSystem() = default;
+
+    virtual const char* GetName() const = 0;
+
+    /// @brief Reads a whole file, throws if it can't be opened or read.
+    /// @param[in] copy Owns the bytes even if the backend would map them, for files that may be rewritten while in use.
+    virtual ResourceData Read(const std::filesystem::path& path, bool copy = false) = 0;
+
+    /// @brief Reads several whole files, backends that can batch reads keep them all in flight. Throws if any can't be read.
+    virtual std::vector<ResourceData> ReadMany(std::span<const std::filesystem::path> paths);
+    virtual bool CanBatch() const; /** @brief Whether ReadMany beats reading each file on a loader thread of its own, the resource manager only batches loose files then. */
+
+    FileSystemStats GetStats() const;
+    void ResetStats();
+
+protected:
+    void CountRead(uint64_t bytes, std::chrono::nanoseconds latency);
+
+private:
+    std::atomic<uint64_t> _reads = 0;
+    std::atomic<uint64_t> _bytes = 0;
+    std::atomic<int64_t> _totalLatency = 0; /** @brief In nanoseconds. */
+    std::atomic<int64_t> _maxLatency = 0;
+};
+
+/** @brief Reads files with std::ifstream into memory it owns. */
+class PlainFileSystem : public FileSystem
+{
+public:
+    const char* GetName() const override;
+    ResourceData Read(const std::filesystem::path& path, bool copy = false) override;
+};
+
+/// @brief Maps files instead of reading them, the default.
+///
+/// Pages are read as a loader first touches them, so only the part of a file that's
+/// used costs anything. The latency it counts is just the mapping, not the page faults.
+class MappedFileSystem : public FileSystem
+{
+public:
+    const char* GetName() const override;
+    ResourceData Read(const std::filesystem::path& path, bool copy = false) override;
+};
+
+/// @brief Reads through io_uring on Linux, every file of a ReadMany is in flight at once.
+///
+/// Each thread gets its own ring the first time it reads, loader threads never wait on
+/// each other's submissions. Where the kernel doesn't allow io_uring, in some containers
+/// for instance, it reads with std::ifstream instead. Throws when made on other systems.
+class UringFileSystem : public FileSystem
+{
+public:
+    UringFileSystem();
+
+    const char* GetName() const override;
+    ResourceData Read(const std::filesystem::path& path, bool copy = false) override;
+    std::vector<ResourceData> ReadMany(std::span<const std::filesystem::path> paths) override;
+    bool CanBatch() const override;
+};
+
+/** @brief Makes a file system by name, Plain, Mapped or Uring. Throws for anything else. */
+std::unique_ptr<FileSystem> CreateFileSystem(std::string_view name);
+
+} // namespace bl
@@ -0,0 +1,152 @@
+#include <cstring>
+
+#include "Core/Platform.h"
+#include "HotReload.h"
+
+#if !defined(BLUEMETAL_SYSTEM_WINDOWS)
+    #include <fcntl.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace bl
+{
+
+#if !defined(BLUEMETAL_SYSTEM_WINDOWS)
+
+// Large enough for any batch a single save produces, bigger batches are split up.
+static constexpr size_t MaxDatagramSize = 16384;
+
+static bool MakeAddress(const std::filesystem::path& path, sockaddr_un& address)
+{
+    auto string = path.string();
+
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (string.size() >= sizeof(address.sun_path))
+        return false;
+
+    std::memcpy(address.sun_path, string.c_str(), string.size() + 1);
+    return true;
+}
+
+#endif
+
+HotReloadSocket::HotReloadSocket()
+    : _socket(-1)
+{
+}
+
+HotReloadSocket::HotReloadSocket(const std::filesystem::path& path)
+    : _path(path)
+    , _socket(-1)
+{
+#if !defined(BLUEMETAL_SYSTEM_WINDOWS)
+    sockaddr_un address;
+    if (!MakeAddress(path, address))
+        throw std::runtime_error("Hot reload socket path is too long: " + path.string());
+
+    _socket = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (_socket < 0)
+        throw std::runtime_error("Could not create the hot reload socket.");
+
+    // Polled once a frame, receiving must never block.
+    fcntl(_socket, F_SETFL, fcntl(_socket, F_GETFL) | O_NONBLOCK);
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+
+    if (bind(_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(_socket);
+        _socket = -1;
+        throw std::runtime_error("Could not bind the hot reload socket: " + path.string());
+    }
+#endif
+}
+
+HotReloadSocket::~HotReloadSocket()
+{
+#if !defined(BLUEMETAL_SYSTEM_WINDOWS)
+    if (_socket >= 0)
+    {
+        close(_socket);
+
+        std::error_code error;
+        std::filesystem::remove(_path, error);
+    }
+#endif
+}
+
+std::vector<std::string> HotReloadSocket::Receive()
+{
+    std::vector<std::string> paths;
+
+#if !defined(BLUEMETAL_SYSTEM_WINDOWS)
+    if (_socket < 0)
+        return paths;
+
+    std::array<char, MaxDatagramSize> buffer;
+    ssize_t size = 0;
+
+    while ((size = recv(_socket, buffer.data(), buffer.size(), 0)) > 0)
+    {
+        std::string_view message{buffer.data(), (size_t)size};
+
+        while (!message.empty())
+        {
+            auto end = message.find('\n');
+            auto line = message.substr(0, end);
+
+            if (!line.empty())
+                paths.emplace_back(line);
+
+            message = end == std::string_view::npos ? std::string_view{} : message.substr(end + 1);
+        }
+    }
+#endif
+
+    return paths;
+}
+
+bool HotReloadSocket::Send(const std::filesystem::path& path, const std::vector<std::string>& paths)
+{
+#if !defined(BLUEMETAL_SYSTEM_WINDOWS)
+    sockaddr_un address;
+    if (!MakeAddress(path, address))
+        return false;
+
+    int sender = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (sender < 0)
+        return false;
+
+    bool sent = true;
+    std::string message;
+
+    // Never waits on a game that stopped draining its socket, those paths are dropped.
+    auto flush = [&](){
+        if (!message.empty() && sendto(sender, message.data(), message.size(), MSG_DONTWAIT, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+            sent = false;
+
+        message.clear();
+    };
+
+    for (const auto& line : paths)
+    {
+        if (message.size() + line.size() + 1 > MaxDatagramSize)
+            flush();
+
+        message += line;
+        message += '\n';
+    }
+
+    flush();
+    close(sender);
+    return sent;
+#else
+    return false;
+#endif
+}
+
+} // namespace bl
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+
+namespace bl
+{
+
+/** @brief Name of the socket a running game listens on, next to the engine manifest. */
+constexpr const char* HotReloadSocketName = "HotReload.sock";
+
+/// @brief A local datagram socket the asset processor uses to tell a running game which
+/// baked resources changed.
+///
+/// Each datagram is a newline separated list of engine manifest paths. Datagrams are
+/// fire and forget, if no game is listening the asset processor just carries on. Only
+/// supported where Unix domain sockets are, elsewhere nothing is ever received.
+class HotReloadSocket : public NonCopyable
+{
+public:
+    /// @brief Default Constructor, a socket that never receives anything.
+    HotReloadSocket();
+
+    /// @brief Binds a socket to listen on, replacing a stale one left by a game that crashed.
+    /// @param[in] path Path of the socket file, throws if it could not be bound.
+    HotReloadSocket(const std::filesystem::path& path);
+
+    /// @brief Destructor, closes the socket and removes its file.
+    ~HotReloadSocket();
+
+    /// @brief Returns every path received since the last call without blocking.
+    std::vector<std::string> Receive();
+
+    /// @brief Sends paths to a listening game.
+    /// @returns False if nobody was listening on the socket.
+    static bool Send(const std::filesystem::path& path, const std::vector<std::string>& paths);
+
+private:
+    std::filesystem::path _path;
+    int _socket;
+};
+
+} // namespace bl
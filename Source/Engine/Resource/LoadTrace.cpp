@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include "LoadTrace.h"
+
+#include <nlohmann/json.hpp>
+
+namespace bl
+{
+
+using Clock = std::chrono::steady_clock;
+
+static thread_local LoadTraceScope* currentScope = nullptr;
+
+const char* ToString(LoadPhase phase)
+{
+    switch (phase)
+    {
+    case LoadPhase::eRead: return "Read";
+    case LoadPhase::eDecompress: return "Decompress";
+    case LoadPhase::eDecode: return "Decode";
+    case LoadPhase::eUpload: return "Upload";
+    case LoadPhase::eSubmit: return "Submit";
+    default: return "Unknown";
+    }
+}
+
+std::chrono::nanoseconds LoadSummary::GetTotal() const
+{
+    return read + decompress + decode + upload;
+}
+
+LoadTracer::LoadTracer()
+    : _epoch(Clock::now())
+{
+}
+
+void LoadTracer::SetEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+bool LoadTracer::IsEnabled() const
+{
+    return _enabled;
+}
+
+void LoadTracer::Record(const std::string& resource, LoadPhase phase, Clock::time_point begin, Clock::time_point end, std::chrono::nanoseconds exclusive)
+{
+    if (!_enabled)
+        return;
+
+    std::lock_guard lock(_mutex);
+
+    auto thread = _threads.try_emplace(std::this_thread::get_id(), (uint32_t)_threads.size()).first->second;
+    LoadSpan span{resource, phase, thread, begin - _epoch, end - begin};
+
+    if (_spans.size() < LoadTraceCapacity)
+        _spans.push_back(std::move(span));
+    else
+        _spans[_nextSpan] = std::move(span);
+
+    _nextSpan = (_nextSpan + 1) % LoadTraceCapacity;
+
+    if (resource.empty())
+        return;
+
+    auto& summary = _summaries[resource];
+    summary.resource = resource;
+
+    switch (phase)
+    {
+    case LoadPhase::eRead: summary.read += exclusive; break;
+    case LoadPhase::eDecompress: summary.decompress += exclusive; break;
+    case LoadPhase::eDecode: summary.decode += exclusive; summary.loads++; break;
+    case LoadPhase::eUpload: summary.upload += exclusive; break;
+    default: break;
+    }
+}
+
+std::vector<LoadSpan> LoadTracer::GetSpans() const
+{
+    std::lock_guard lock(_mutex);
+    if (_spans.size() < LoadTraceCapacity)
+        return _spans;
+
+    std::vector<LoadSpan> spans;
+    spans.reserve(_spans.size());
+    spans.insert(spans.end(), _spans.begin() + _nextSpan, _spans.end());
+    spans.insert(spans.end(), _spans.begin(), _spans.begin() + _nextSpan);
+    return spans;
+}
+
+std::vector<LoadSummary> LoadTracer::GetSlowest(std::size_t count) const
+{
+    std::vector<LoadSummary> slowest;
+    {
+        std::lock_guard lock(_mutex);
+        for (const auto& [resource, summary] : _summaries)
+            slowest.push_back(summary);
+    }
+
+    count = std::min(count, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), [](const LoadSummary& a, const LoadSummary& b){
+        return a.GetTotal() > b.GetTotal();
+    });
+
+    slowest.resize(count);
+    return slowest;
+}
+
+void LoadTracer::Clear()
+{
+    std::lock_guard lock(_mutex);
+    _spans.clear();
+    _nextSpan = 0;
+    _summaries.clear();
+}
+
+void LoadTracer::ExportChromeTrace(const std::filesystem::path& path) const
+{
+    auto spans = GetSpans();
+
+    // Complete events ("X"), the format counts in microseconds.
+    auto events = nlohmann::json::array();
+    for (const auto& span : spans)
+    {
+        nlohmann::json event;
+        if (!span.resource.empty())
+            event["name"] = span.resource;
+        else
+            event["name"] = span.phase == LoadPhase::eRead ? "Read batch" : "Upload batch";
+        event["cat"] = ToString(span.phase);
+        event["ph"] = "X";
+        event["ts"] = std::chrono::duration<double, std::micro>(span.begin).count();
+        event["dur"] = std::chrono::duration<double, std::micro>(span.duration).count();
+        event["pid"] = 1;
+        event["tid"] = span.thread;
+        event["args"] = {{"phase", ToString(span.phase)}};
+        events.push_back(std::move(event));
+    }
+
+    nlohmann::json trace;
+    trace["traceEvents"] = std::move(events);
+    trace["displayTimeUnit"] = "ms";
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open a file to write the load trace to: " + path.string());
+
+    file << trace.dump();
+
+    if (!file)
+        throw std::runtime_error("Could not write the load trace: " + path.string());
+}
+
+LoadTraceScope::LoadTraceScope(LoadTracer& tracer, const std::filesystem::path& resource, LoadPhase phase)
+    : _tracer(tracer)
+    , _resource(resource)
+    , _phase(phase)
+    , _begin(Clock::now())
+    , _parent(currentScope)
+{
+    currentScope = this;
+}
+
+LoadTraceScope::~LoadTraceScope()
+{
+    auto end = Clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - _begin);
+
+    currentScope = _parent;
+    if (_parent)
+        _parent->_nested += duration;
+
+    _tracer.Record(_resource.generic_string(), _phase, _begin, end, duration - _nested);
+}
+
+} // namespace bl
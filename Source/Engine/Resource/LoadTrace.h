@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace bl
+{
+
+enum class LoadPhase
+{
+    eRead, /** @brief Reading the resource's file, pack reads are mapped so their page faults land in whatever touches them. */
+    eDecompress, /** @brief Decompressing a compressed payload's chunks, nested in its read. */
+    eDecode, /** @brief Resource::LoadData, on a loader thread. */
+    eUpload, /** @brief Resource::FinishLoad, on the render thread. */
+    eSubmit, /** @brief Submitting and waiting for a batch of uploads, not tied to one resource. */
+};
+
+const char* ToString(LoadPhase phase);
+
+constexpr std::size_t LoadTraceCapacity = 64 * 1024; /** @brief Spans a tracer keeps, a few MB. Past it the oldest are overwritten. */
+
+/** @brief A phase of one load, times are from when the tracer was made. */
+struct LoadSpan
+{
+    std::string resource; /** @brief Empty for a submission or a batched read of several loose files. */
+    LoadPhase phase;
+    uint32_t thread; /** @brief Threads are numbered in the order they first recorded a span. */
+    std::chrono::nanoseconds begin;
+    std::chrono::nanoseconds duration;
+};
+
+/** @brief Where the time of every load of a resource went, nested phases aren't counted twice. */
+struct LoadSummary
+{
+    std::string resource;
+    uint32_t loads = 0;
+    std::chrono::nanoseconds read{0};
+    std::chrono::nanoseconds decompress{0};
+    std::chrono::nanoseconds decode{0};
+    std::chrono::nanoseconds upload{0};
+
+    std::chrono::nanoseconds GetTotal() const;
+};
+
+/// @brief Records a span for each phase of every load, see ResourceManager::GetLoadTracer.
+///
+/// Spans come from loader threads and the render thread at once. They're exported in
+/// the Chrome trace event format, open the file in chrome://tracing or ui.perfetto.dev.
+/// Phases nest, a read is usually inside a decode, so the timeline shows both while the
+/// summaries only count the read once. Only the newest LoadTraceCapacity spans are kept so
+/// a long session's reloads and evictions don't grow it without bound, the summaries keep
+/// counting everything.
+class LoadTracer : public NonCopyable
+{
+public:
+    LoadTracer();
+
+    void SetEnabled(bool enabled); /** @brief On by default, a span costs a lock and a push. */
+    bool IsEnabled() const;
+
+    /// @brief Records a span, thread safe.
+    /// @param[in] exclusive The part of the span not spent in spans nested inside it.
+    void Record(const std::string& resource, LoadPhase phase, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, std::chrono::nanoseconds exclusive);
+
+    std::vector<LoadSpan> GetSpans() const; /** @brief Oldest first. */
+    std::vector<LoadSummary> GetSlowest(std::size_t count) const; /** @brief Resources whose loads took the longest in total, slowest first. */
+    void Clear();
+
+    void ExportChromeTrace(const std::filesystem::path& path) const; /** @brief Writes every span as a trace event JSON file, throws if it can't be written. */
+
+private:
+    std::atomic<bool> _enabled = true;
+    std::chrono::steady_clock::time_point _epoch;
+    mutable std::mutex _mutex;
+    std::vector<LoadSpan> _spans; /** @brief A ring once it's full. */
+    std::size_t _nextSpan = 0; /** @brief Where the next span goes, the oldest once the ring is full. */
+    std::unordered_map<std::string, LoadSummary> _summaries; /** @brief Kept as spans come in, so a table of the slowest can be drawn every frame. */
+    std::unordered_map<std::thread::id, uint32_t> _threads;
+};
+
+/// @brief Times a phase from construction to destruction.
+///
+/// Scopes on one thread nest, each tells the one it's inside how long it took so that
+/// one can record its exclusive time.
+class LoadTraceScope : public NonCopyable
+{
+public:
+    LoadTraceScope(LoadTracer& tracer, const std::filesystem::path& resource, LoadPhase phase);
+    ~LoadTraceScope();
+
+private:
+    LoadTracer& _tracer;
+    std::filesystem::path _resource;
+    LoadPhase _phase;
+    std::chrono::steady_clock::time_point _begin;
+    std::chrono::nanoseconds _nested{0};
+    LoadTraceScope* _parent;
+};
+
+} // namespace bl
@@ -0,0 +1,237 @@
+#include <cstring>
+
+#include "Core/Hash.h"
+#include "Manifest.h"
+#include "PerfectHash.h"
+
+namespace bl
+{
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static ResourceData BuildFromJson(const std::filesystem::path& path, ResourceData data)
+{
+    if (path.extension() != ".json")
+        return data;
+
+    auto bytes = data.GetSpan();
+    auto* text = reinterpret_cast<const char*>(bytes.data());
+    return ResourceData{Manifest::Build(nlohmann::json::parse(text, text + bytes.size()))};
+}
+
+Manifest::Manifest(const std::filesystem::path& path, ResourceData file)
+    : _data(BuildFromJson(path, std::move(file)))
+{
+    auto data = _data.GetSpan();
+
+    if (data.size() < sizeof(ManifestHeader))
+        throw std::runtime_error("Manifest is too small to be valid: " + path.string());
+
+    _header = reinterpret_cast<const ManifestHeader*>(data.data());
+
+    if (std::memcmp(_header->magic, "BMAN", 4) != 0 || _header->version != ManifestVersion)
+        throw std::runtime_error("Manifest has an invalid header or version, it needs to be baked again: " + path.string());
+
+    if ((_header->numBuckets == 0) != (_header->numResources == 0))
+        throw std::runtime_error("Manifest has no perfect hash for its resources: " + path.string());
+
+    // Only the tables are checked here, strings are checked as they're read so loading stays O(1).
+    auto inBounds = [&](uint64_t offset, uint64_t size, size_t alignment){
+        return offset % alignment == 0 && offset <= data.size() && size <= data.size() - offset;
+    };
+
+    if (!inBounds(_header->displacementsOffset, (uint64_t)_header->numBuckets * sizeof(int32_t), alignof(int32_t)) ||
+        !inBounds(_header->entriesOffset, (uint64_t)_header->numResources * sizeof(ManifestEntry), alignof(ManifestEntry)) ||
+        !inBounds(_header->packsOffset, (uint64_t)_header->numPacks * sizeof(ManifestString), alignof(ManifestString)) ||
+        !inBounds(_header->groupsOffset, (uint64_t)_header->numGroups * sizeof(ManifestGroup), alignof(ManifestGroup)) ||
+        !inBounds(_header->membersOffset, (uint64_t)_header->numMembers * sizeof(uint32_t), alignof(uint32_t)) ||
+        !inBounds(_header->stringsOffset, _header->stringsSize, 1))
+        throw std::runtime_error("Manifest table is out of bounds: " + path.string());
+
+    _displacements = {reinterpret_cast<const int32_t*>(data.data() + _header->displacementsOffset), _header->numBuckets};
+    _entries = {reinterpret_cast<const ManifestEntry*>(data.data() + _header->entriesOffset), _header->numResources};
+    _packs = {reinterpret_cast<const ManifestString*>(data.data() + _header->packsOffset), _header->numPacks};
+    _groups = {reinterpret_cast<const ManifestGroup*>(data.data() + _header->groupsOffset), _header->numGroups};
+    _members = {reinterpret_cast<const uint32_t*>(data.data() + _header->membersOffset), _header->numMembers};
+    _strings = {reinterpret_cast<const char*>(data.data() + _header->stringsOffset), (size_t)_header->stringsSize};
+}
+
+Manifest::~Manifest()
+{
+}
+
+std::vector<std::byte> Manifest::Build(const nlohmann::json& root)
+{
+    const auto& resources = root.at("Resources");
+
+    std::string strings;
+    auto addString = [&](std::string_view string){
+        ManifestString out{(uint32_t)strings.size(), (uint32_t)string.size()};
+        strings += string;
+        return out;
+    };
+
+    std::vector<uint64_t> hashes;
+    std::vector<ManifestEntry> records;
+
+    for (const auto& resource : resources)
+    {
+        auto path = resource.at("Path").get<std::string>();
+
+        ManifestEntry entry{};
+        entry.pathHash = Hash64(path);
+        entry.path = addString(path);
+        entry.type = addString(resource.at("Type").get<std::string>());
+        entry.properties = addString(resource.dump());
+
+        hashes.push_back(entry.pathHash);
+        records.push_back(entry);
+    }
+
+    std::vector<ManifestString> packs;
+    for (const auto& pack : root.value("Packs", nlohmann::json::array()))
+        packs.push_back(addString(pack.get<std::string>()));
+
+    std::vector<uint32_t> slots;
+    auto displacements = BuildPerfectHash(hashes, slots);
+
+    std::vector<ManifestEntry> entries(records.size());
+    std::unordered_map<uint64_t, uint32_t> slotByHash;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        entries[slots[i]] = records[i];
+        slotByHash[records[i].pathHash] = slots[i];
+    }
+
+    std::vector<ManifestGroup> groups;
+    std::vector<uint32_t> members;
+    for (const auto& group : root.value("Groups", nlohmann::json::array()))
+    {
+        ManifestGroup out{};
+        out.name = addString(group.at("Name").get<std::string>());
+        out.firstMember = (uint32_t)members.size();
+
+        for (const auto& path : group.at("Resources"))
+        {
+            auto slot = slotByHash.find(Hash64(path.get<std::string>()));
+            if (slot == slotByHash.end())
+                throw std::runtime_error("Manifest group " + group.at("Name").get<std::string>() + " has a resource that isn't in the manifest: " + path.get<std::string>());
+
+            members.push_back(slot->second);
+        }
+
+        out.numMembers = (uint32_t)members.size() - out.firstMember;
+        groups.push_back(out);
+    }
+
+    if (strings.size() > UINT32_MAX)
+        throw std::runtime_error("Manifest strings are too large.");
+
+    ManifestHeader header{};
+    std::memcpy(header.magic, "BMAN", 4);
+    header.version = ManifestVersion;
+    header.numResources = (uint32_t)entries.size();
+    header.numPacks = (uint32_t)packs.size();
+    header.numBuckets = (uint32_t)displacements.size();
+    header.numGroups = (uint32_t)groups.size();
+    header.numMembers = (uint32_t)members.size();
+    header.entriesOffset = sizeof(ManifestHeader);
+    header.displacementsOffset = header.entriesOffset + entries.size() * sizeof(ManifestEntry);
+    header.packsOffset = AlignUp(header.displacementsOffset + displacements.size() * sizeof(int32_t), alignof(ManifestString));
+    header.groupsOffset = header.packsOffset + packs.size() * sizeof(ManifestString);
+    header.membersOffset = header.groupsOffset + groups.size() * sizeof(ManifestGroup);
+    header.stringsOffset = header.membersOffset + members.size() * sizeof(uint32_t);
+    header.stringsSize = strings.size();
+
+    std::vector<std::byte> out(header.stringsOffset + header.stringsSize);
+    auto write = [&](uint64_t offset, const void* source, size_t size){
+        if (size > 0)
+            std::memcpy(out.data() + offset, source, size);
+    };
+
+    write(0, &header, sizeof(header));
+    write(header.entriesOffset, entries.data(), entries.size() * sizeof(ManifestEntry));
+    write(header.displacementsOffset, displacements.data(), displacements.size() * sizeof(int32_t));
+    write(header.packsOffset, packs.data(), packs.size() * sizeof(ManifestString));
+    write(header.groupsOffset, groups.data(), groups.size() * sizeof(ManifestGroup));
+    write(header.membersOffset, members.data(), members.size() * sizeof(uint32_t));
+    write(header.stringsOffset, strings.data(), strings.size());
+
+    return out;
+}
+
+uint32_t Manifest::GetCount() const
+{
+    return (uint32_t)_entries.size();
+}
+
+std::optional<uint32_t> Manifest::Find(uint64_t pathHash) const
+{
+    if (_entries.empty())
+        return std::nullopt;
+
+    auto slot = PerfectHashSlot(pathHash, _displacements, (uint32_t)_entries.size());
+    if (slot >= _entries.size() || _entries[slot].pathHash != pathHash)
+        return std::nullopt;
+
+    return slot;
+}
+
+const ManifestEntry& Manifest::GetEntry(uint32_t slot) const
+{
+    return _entries[slot];
+}
+
+std::string_view Manifest::GetString(const ManifestString& string) const
+{
+    if (string.offset > _strings.size() || string.length > _strings.size() - string.offset)
+        throw std::runtime_error("Manifest string is out of bounds.");
+
+    return _strings.substr(string.offset, string.length);
+}
+
+nlohmann::json Manifest::GetProperties(uint32_t slot) const
+{
+    return nlohmann::json::parse(GetString(_entries[slot].properties));
+}
+
+std::vector<std::string_view> Manifest::GetPacks() const
+{
+    std::vector<std::string_view> packs;
+    for (const auto& pack : _packs)
+        packs.push_back(GetString(pack));
+
+    return packs;
+}
+
+std::optional<uint32_t> Manifest::FindGroup(std::string_view name) const
+{
+    for (uint32_t i = 0; i < _groups.size(); i++)
+    {
+        if (GetString(_groups[i].name) == name)
+            return i;
+    }
+
+    return std::nullopt;
+}
+
+std::span<const uint32_t> Manifest::GetGroupMembers(uint32_t group) const
+{
+    const auto& info = _groups[group];
+    if (info.firstMember > _members.size() || info.numMembers > _members.size() - info.firstMember)
+        throw std::runtime_error("Manifest group is out of bounds.");
+
+    auto members = _members.subspan(info.firstMember, info.numMembers);
+    for (auto slot : members)
+    {
+        if (slot >= _entries.size())
+            throw std::runtime_error("Manifest group has a resource that is out of bounds.");
+    }
+
+    return members;
+}
+
+} // namespace bl
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/NonCopyable.h"
+#include "ManifestFormat.h"
+#include "ResourceData.h"
+
+#include <nlohmann/json.hpp>
+
+namespace bl
+{
+
+/// @brief An engine manifest, see Resource/ManifestFormat.h.
+///
+/// Binary manifests are mapped and used in place. A JSON manifest is built into the
+/// same layout when it's loaded, so both are looked up the same way.
+class Manifest : public NonCopyable
+{
+public:
+    Manifest(const std::filesystem::path& path, ResourceData file); /** @brief Uses a binary manifest in place, or builds one from a .json file. Throws if it's malformed. */
+    ~Manifest();
+
+    /// @brief Builds a binary manifest from the JSON one, throws if two paths have the same hash.
+    /// @param root The JSON manifest, see the end of Resource/ResourceManager.h.
+    static std::vector<std::byte> Build(const nlohmann::json& root);
+
+    uint32_t GetCount() const; /** @brief Number of resources, their slots go from zero to this. */
+    std::optional<uint32_t> Find(uint64_t pathHash) const; /** @brief Returns the slot of a resource by its path hash, without allocating. */
+    const ManifestEntry& GetEntry(uint32_t slot) const;
+    std::string_view GetString(const ManifestString& string) const; /** @brief Throws if the string is out of bounds. */
+    nlohmann::json GetProperties(uint32_t slot) const; /** @brief Parses the object a resource's builder is given, only when it's first used. */
+    std::vector<std::string_view> GetPacks() const;
+    std::optional<uint32_t> FindGroup(std::string_view name) const; /** @brief Groups are few, they're searched by name. */
+    std::span<const uint32_t> GetGroupMembers(uint32_t group) const; /** @brief Slots of the group's resources, throws if any is out of bounds. */
+
+private:
+    ResourceData _data;
+    const ManifestHeader* _header;
+    std::span<const int32_t> _displacements;
+    std::span<const ManifestEntry> _entries;
+    std::span<const ManifestString> _packs;
+    std::span<const ManifestGroup> _groups;
+    std::span<const uint32_t> _members;
+    std::string_view _strings;
+};
+
+} // namespace bl
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bl
+{
+
+// A binary manifest is the engine manifest made to be memory mapped, nothing in it is
+// parsed when it's loaded. Resources are found by the 64-bit FNV-1a hash (bl::Hash64)
+// of their manifest path through a minimal perfect hash, see Resource/PerfectHash.h.
+// The slot it returns is the resource's entry, a lookup is one probe and a compare of
+// the stored hash. Manifest.json is still written next to it for people to read.
+//
+// Manifest (header)
+//  magic               (char[4]) 'B' 'M' 'A' 'N'
+//  version             (uint32_t) (2)
+//  numResources        (uint32_t)
+//  numPacks            (uint32_t)
+//  numBuckets          (uint32_t) Size of the displacement table.
+//  numGroups           (uint32_t)
+//  numMembers          (uint32_t) Resources in all groups together.
+//  reserved            (uint32_t)
+//  displacementsOffset (uint64_t)
+//  entriesOffset       (uint64_t)
+//  packsOffset         (uint64_t)
+//  groupsOffset        (uint64_t)
+//  membersOffset       (uint64_t)
+//  stringsOffset       (uint64_t)
+//  stringsSize         (uint64_t)
+//
+// Entries (array, in perfect hash slot order)
+//  ManifestEntry       (sizeof(ManifestEntry) * numResources)
+//
+// Displacements (array)
+//  int32_t             (4 * numBuckets)
+//
+// Packs (array)
+//  ManifestString      (sizeof(ManifestString) * numPacks) Pack paths relative to the manifest.
+//
+// Groups (array)
+//  ManifestGroup       (sizeof(ManifestGroup) * numGroups) Named sets of resources loaded together.
+//
+// Members (array)
+//  uint32_t            (4 * numMembers) Resource slots, each group's one after another.
+//
+// Strings
+//  Paths, types and each resource's properties as the JSON object the resource's
+//  builder is given, not null terminated.
+
+constexpr uint32_t ManifestVersion = 2;
+
+struct ManifestHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numResources;
+    uint32_t numPacks;
+    uint32_t numBuckets;
+    uint32_t numGroups;
+    uint32_t numMembers;
+    uint32_t reserved;
+    uint64_t displacementsOffset;
+    uint64_t entriesOffset;
+    uint64_t packsOffset;
+    uint64_t groupsOffset;
+    uint64_t membersOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct ManifestString
+{
+    uint32_t offset; /** @brief From the start of the strings. */
+    uint32_t length;
+};
+
+struct ManifestEntry
+{
+    uint64_t pathHash;
+    ManifestString path;
+    ManifestString type;
+    ManifestString properties;
+};
+
+struct ManifestGroup
+{
+    ManifestString name;
+    uint32_t firstMember; /** @brief Index into the members. */
+    uint32_t numMembers;
+};
+
+static_assert(sizeof(ManifestHeader) == 88);
+static_assert(sizeof(ManifestString) == 8);
+static_assert(sizeof(ManifestEntry) == 32);
+static_assert(sizeof(ManifestGroup) == 16);
+
+} // namespace bl
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bl
+{
+
+// A resource pack is every baked resource in one file, made to be memory mapped.
+// Resources are found with a binary search of the table of contents by the 64-bit
+// FNV-1a hash (bl::Hash64) of their manifest path, with '/' separators.
+//
+// Pack (header)
+//  magic       (char[4]) 'B' 'P' 'A' 'K'
+//  version     (uint32_t) (2)
+//  numEntries  (uint32_t)
+//  alignment   (uint32_t) Every payload offset is a multiple of this.
+//  tocOffset   (uint64_t)
+//  dataOffset  (uint64_t)
+//
+// Table Of Contents (array, sorted by pathHash)
+//  PackEntry   (sizeof(PackEntry) * numEntries)
+//
+// Data
+//  Payloads, each starting at a multiple of alignment. A payload flagged with
+//  PackEntryCompressed is split into compressed chunks, see Resource/CompressedFormat.h,
+//  and its size is what it takes up in the pack.
+
+constexpr uint32_t PackVersion = 2;
+constexpr uint32_t PackAlignment = 64;
+
+enum PackEntryFlags : uint32_t
+{
+    PackEntryCompressed = 1 << 0,
+};
+
+struct PackHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t alignment;
+    uint64_t tocOffset;
+    uint64_t dataOffset;
+};
+
+struct PackEntry
+{
+    uint64_t pathHash;
+    uint64_t offset; /** @brief From the start of the file. */
+    uint64_t size;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 32);
+static_assert(sizeof(PackEntry) == 32);
+
+} // namespace bl
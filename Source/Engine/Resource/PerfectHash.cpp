@@ -0,0 +1,85 @@
+#include "PerfectHash.h"
+
+#include <numeric>
+
+namespace bl
+{
+
+std::vector<int32_t> BuildPerfectHash(std::span<const uint64_t> keys, std::vector<uint32_t>& slots)
+{
+    auto numKeys = (uint32_t)keys.size();
+    slots.assign(numKeys, 0);
+
+    if (numKeys == 0)
+        return {};
+
+    // Two equal keys never land in different slots, no displacement would ever be found.
+    std::vector<uint64_t> sorted{keys.begin(), keys.end()};
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+        throw std::runtime_error("Could not build a perfect hash, two keys are the same.");
+
+    uint32_t numBuckets = numKeys;
+    std::vector<std::vector<uint32_t>> buckets(numBuckets);
+    for (uint32_t i = 0; i < numKeys; i++)
+        buckets[PerfectHashMix(keys[i], 0) % numBuckets].push_back(i);
+
+    // The largest buckets are the hardest to place, they go while most slots are free.
+    std::vector<uint32_t> order(numBuckets);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){ return buckets[a].size() > buckets[b].size(); });
+
+    std::vector<int32_t> displacements(numBuckets, 0);
+    std::vector<bool> occupied(numKeys, false);
+    std::vector<uint32_t> placed;
+
+    size_t next = 0;
+    for (; next < order.size() && buckets[order[next]].size() > 1; next++)
+    {
+        const auto& bucket = buckets[order[next]];
+
+        for (int32_t displacement = 1;; displacement++)
+        {
+            if (displacement == INT32_MAX)
+                throw std::runtime_error("Could not build a perfect hash, no displacement fits a bucket.");
+
+            placed.clear();
+            for (uint32_t key : bucket)
+            {
+                auto slot = (uint32_t)(PerfectHashMix(keys[key], (uint64_t)displacement) % numKeys);
+                if (occupied[slot] || std::find(placed.begin(), placed.end(), slot) != placed.end())
+                    break;
+
+                placed.push_back(slot);
+            }
+
+            if (placed.size() != bucket.size())
+                continue;
+
+            for (size_t i = 0; i < bucket.size(); i++)
+            {
+                occupied[placed[i]] = true;
+                slots[bucket[i]] = placed[i];
+            }
+
+            displacements[order[next]] = displacement;
+            break;
+        }
+    }
+
+    // Single keys take whatever is left, in order.
+    uint32_t free = 0;
+    for (; next < order.size() && buckets[order[next]].size() == 1; next++)
+    {
+        while (occupied[free])
+            free++;
+
+        occupied[free] = true;
+        slots[buckets[order[next]][0]] = free;
+        displacements[order[next]] = -(int32_t)free - 1;
+    }
+
+    return displacements;
+}
+
+} // namespace bl
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Precompiled.h"
+
+namespace bl
+{
+
+// A minimal perfect hash maps n distinct keys onto the slots 0 to n - 1 without two
+// keys sharing a slot, built with hash and displace. Keys are spread over buckets,
+// each bucket then gets the first displacement that puts all of its keys in free
+// slots, largest buckets first. Buckets holding a single key store the free slot
+// itself instead, as -(slot + 1). Keys that weren't built in still map to a slot,
+// whoever looks one up compares the key stored there.
+
+/** @brief Mixes a key with a displacement, splitmix64's finalizer. */
+constexpr uint64_t PerfectHashMix(uint64_t key, uint64_t displacement)
+{
+    uint64_t x = key ^ (displacement * 0x9e3779b97f4a7c15ull);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/** @brief Returns the slot of a key, anything if the key wasn't built in. The table must not be empty. */
+inline uint32_t PerfectHashSlot(uint64_t key, std::span<const int32_t> displacements, uint32_t numSlots)
+{
+    int32_t displacement = displacements[PerfectHashMix(key, 0) % displacements.size()];
+    if (displacement < 0)
+        return (uint32_t)(-(displacement + 1));
+
+    return (uint32_t)(PerfectHashMix(key, (uint64_t)displacement) % numSlots);
+}
+
+/// @brief Builds the displacement table for a set of keys, one bucket per key.
+/// @param[in] keys Must all be different, throws if two are the same.
+/// @param[out] slots The slot of each key, in the same order as keys.
+std::vector<int32_t> BuildPerfectHash(std::span<const uint64_t> keys, std::vector<uint32_t>& slots);
+
+} // namespace bl
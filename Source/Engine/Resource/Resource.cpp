@@ -1,10 +1,12 @@
 #include "Resource.h"
+#include "ResourceManager.h"
 
 namespace bl
 {
 
 Resource::Resource(ResourceManager* manager, const nlohmann::json&) 
     : _manager(manager)
+    , _state(ResourceState::eUnloaded)
 {
 }
 
@@ -19,6 +21,11 @@ const std::string& Resource::GetName() const
     return _name;
 }
 
+const std::string& Resource::GetType() const
+{
+    return _type;
+}
+
 const std::filesystem::path& Resource::GetPath() const 
 {
     return _path;
@@ -34,6 +41,11 @@ ResourceState Resource::GetState() const
     return _state;
 }
 
+const std::vector<ResourceId>& Resource::GetDependencies() const
+{
+    return _dependencies;
+}
+
 void Resource::Load() 
 {
     _state = ResourceState::eLoaded;
@@ -44,6 +56,11 @@ void Resource::Unload()
     _state = ResourceState::eUnloaded;
 }
 
+void Resource::SetType(const std::string& type)
+{
+    _type = type;
+}
+
 void Resource::SetPath(const std::filesystem::path& path) 
 {
     _path = path;
@@ -59,4 +76,19 @@ void Resource::SetState(ResourceState state)
     _state = state;
 }
 
+void Resource::SetDependencies(std::vector<ResourceId> dependencies)
+{
+    _dependencies = std::move(dependencies);
+}
+
+ResourceData Resource::ReadData() const
+{
+    return _manager->Read(_path);
+}
+
+ThreadPool& Resource::GetWorkerPool() const
+{
+    return _manager->GetWorkerPool();
+}
+
 } // namespace bl
\ No newline at end of file
@@ -2,7 +2,11 @@
 
 #include "Precompiled.h"
 #include "Core/ReferenceCounted.h"
+#include "Core/ThreadPool.h"
+#include "ResourceData.h"
+#include "ResourceId.h"
 
+#include <atomic>
 #include <nlohmann/json.hpp>
 
 namespace bl 
@@ -23,6 +27,13 @@ enum class ResourceState
     eUnloaded,
 };
 
+/** @brief Memory a loaded resource holds, see ResourceManager::SetBudget. */
+struct ResourceMemory
+{
+    std::size_t cpuBytes = 0;
+    std::size_t gpuBytes = 0;
+};
+
 class Resource : public ReferenceCounted 
 {
 public:
@@ -30,27 +41,52 @@ public:
     virtual ~Resource();
 
     const std::string& GetName() const;
+    const std::string& GetType() const; /** @brief The type from the manifest, budgets are per type. */
     const std::filesystem::path& GetPath() const;
     ResourceLoadOp GetLoadOp() const;
     ResourceState GetState() const;
+    const std::vector<ResourceId>& GetDependencies() const; /** @brief From the manifest, loaded before this resource and kept loaded while it is. */
 
     virtual void Load() = 0;
     virtual void Unload() = 0;
 
+    /// @brief The part of a load ResourceManager::LoadAsync runs on a loader thread.
+    ///
+    /// Reads and decodes, anything that doesn't need the render thread. Resources that
+    /// split their load implement Load() as LoadData() then FinishLoad(). Does nothing
+    /// by default, leaving the whole load to FinishLoad().
+    virtual void LoadData() {}
+
+    /// @brief The rest of an asynchronous load, run on the render thread inside an upload
+    /// batch once LoadData() returned. Loads the whole resource by default.
+    virtual void FinishLoad() { Load(); }
+
+    /// @brief Roughly what the resource holds while loaded, counted against its type's budget.
+    /// Only called on the render thread while no load of it is in flight.
+    virtual ResourceMemory GetMemoryUsage() const { return {}; }
+
 protected:
     friend class ResourceManager;
 
     void SetName(const std::string& name);
+    void SetType(const std::string& type);
     void SetPath(const std::filesystem::path& path);
     void SetLoadOp(ResourceLoadOp op);
     void SetState(ResourceState state);
+    void SetDependencies(std::vector<ResourceId> dependencies);
+    ResourceData ReadData() const; /** @brief Reads this resource's file through the manager, zero copy if it's in a pack. */
+    ThreadPool& GetWorkerPool() const; /** @brief The manager's pool for splitting up a load, see ResourceManager::GetWorkerPool. */
 
 private:
     ResourceManager* _manager;
     std::string _name;
+    std::string _type;
     std::filesystem::path _path; /** @brief Usually a path to the resource in the filesystem. Name of the resource as described in the manifest, must be unique. */
     ResourceLoadOp _loadOp;
-    ResourceState _state;
+    std::atomic<ResourceState> _state; /** @brief Set by LoadData() on a loader thread too, while the render thread may be checking it. */
+    std::vector<ResourceId> _dependencies;
+    std::vector<ReferenceCounter<Resource>> _heldDependencies; /** @brief Set by the manager while loaded, so nothing evicts a dependency from under it. */
+    std::chrono::steady_clock::time_point _lastUsed; /** @brief When it was last loaded or seen referenced, the least recently used are evicted first. */
 };
 
 template<class T>
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/MappedFile.h"
+
+namespace bl
+{
+
+/// @brief The bytes of a resource file.
+///
+/// Resources found in a mounted pack are a view straight into the mapped pack and
+/// cost no copy, loose files are mapped on their own. Bytes decoded at load time are
+/// owned by this object. Either way the bytes are valid for as long as this object
+/// and its resource manager are.
+class ResourceData
+{
+public:
+    ResourceData() = default;
+    ResourceData(std::span<const std::byte> view) : _view(view) {}
+    ResourceData(std::vector<std::byte>&& owned) : _owned(std::move(owned)) {}
+    ResourceData(std::shared_ptr<const MappedFile> file) : _view(file->GetData()), _file(std::move(file)) {}
+
+    std::span<const std::byte> GetSpan() const { return _owned.empty() ? _view : std::span<const std::byte>{_owned}; }
+    size_t GetSize() const { return GetSpan().size(); }
+    bool IsEmpty() const { return GetSpan().empty(); }
+
+private:
+    std::span<const std::byte> _view;
+    std::vector<std::byte> _owned;
+    std::shared_ptr<const MappedFile> _file; /** @brief Keeps a loose file mapped while the view is in use. */
+};
+
+} // namespace bl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/CTTI.h"
+#include "Core/Hash.h"
+
+namespace bl
+{
+
+/// @brief Names a resource by the 64-bit hash of its manifest path, see Resource/ManifestFormat.h.
+///
+/// String literals are hashed at compile time, Load<T>("Models/Fox.bmm") looks the
+/// resource up without hashing or allocating anything at runtime. Paths only known
+/// at runtime are hashed once when the id is made.
+class ResourceId
+{
+public:
+    constexpr ResourceId() : _hash(0) {}
+    constexpr explicit ResourceId(uint64_t hash) : _hash(hash) {}
+
+    template<size_t N>
+    consteval ResourceId(const char (&path)[N]) : _hash(Hash64_CT(path)) {}
+
+    ResourceId(std::string_view path) : _hash(Hash64(path)) {}
+    ResourceId(const std::string& path) : _hash(Hash64(path)) {}
+
+    constexpr uint64_t GetHash() const { return _hash; }
+
+    constexpr bool operator==(const ResourceId&) const = default;
+
+private:
+    uint64_t _hash;
+};
+
+} // namespace bl
+
+template<>
+struct std::hash<bl::ResourceId>
+{
+    size_t operator()(const bl::ResourceId& id) const noexcept { return (size_t)id.GetHash(); }
+};
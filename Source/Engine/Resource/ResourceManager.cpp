@@ -1,14 +1,41 @@
+#include <algorithm>
+
 #include "ResourceManager.h"
+#include "Core/Hash.h"
+#include "Core/Print.h"
+#include "Compression.h"
 
 namespace bl
 {
 
 ResourceManager::ResourceManager()
+    : _fileSystem(std::make_unique<MappedFileSystem>())
 {
 }
 
 ResourceManager::~ResourceManager()
 {
+    // Loads still queued skip their read, _loaders then only waits for those already reading.
+    for (auto& [resource, load] : _loading)
+        load->_cancelled = true;
+
+    // Slots are destroyed in order, a dependency may go before what holds a reference to it.
+    for (auto& resource : _resources)
+    {
+        if (resource)
+            resource->_heldDependencies.clear();
+    }
+
+    auto stats = _fileSystem->GetStats();
+    blVerbose("{} file system read {} files, {} bytes, {} us on average, {} us at most, {:.1f} MB/s.", _fileSystem->GetName(), stats.reads, stats.bytes,
+        std::chrono::duration_cast<std::chrono::microseconds>(stats.GetAverageLatency()).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(stats.maxLatency).count(),
+        stats.GetThroughput() / 1e6);
+}
+
+ThreadPool& ResourceManager::GetWorkerPool()
+{
+    return _workers;
 }
 
 void ResourceManager::RegisterBuilder(std::vector<std::string> types, ResourceBuilder* builder)
@@ -17,37 +44,854 @@ void ResourceManager::RegisterBuilder(std::vector<std::string> types, ResourceBu
         _builders.emplace(type, builder);
 }
 
+void ResourceManager::SetFileSystem(std::unique_ptr<FileSystem> fileSystem)
+{
+    _fileSystem = std::move(fileSystem);
+}
+
+FileSystem& ResourceManager::GetFileSystem()
+{
+    return *_fileSystem;
+}
+
+LoadTracer& ResourceManager::GetLoadTracer()
+{
+    return _tracer;
+}
+
 void ResourceManager::LoadFromManifest(const std::filesystem::path& manifest)
 {
-    using namespace nlohmann;
-    
-    std::ifstream file(manifest);
-    json root = json::parse(file);
-    json resources = root["Resources"];
+    if (_manifest)
+    {
+        throw std::runtime_error("Could not load a manifest as one is already loaded!");
+    }
+
+    _manifest = std::make_unique<Manifest>(manifest, _fileSystem->Read(manifest));
+    _root = manifest.parent_path();
+
+    for (auto pack : _manifest->GetPacks())
+    {
+        MountPack(_root / pack);
+    }
+
+    // Manifest resources own the first slots, runtime resources added before move up behind them.
+    auto count = _manifest->GetCount();
+    std::vector<std::unique_ptr<Resource>> resources(count);
+    std::move(_resources.begin(), _resources.end(), std::back_inserter(resources));
+    _resources = std::move(resources);
+
+    for (auto& [id, slot] : _runtimeSlots)
+        slot += count;
+
+    for (auto& slot : _freeSlots)
+        slot += count;
+}
+
+Resource* ResourceManager::FindResource(ResourceId id)
+{
+    if (_manifest)
+    {
+        if (auto slot = _manifest->Find(id.GetHash()))
+            return GetManifestResource(*slot);
+    }
+
+    auto it = _runtimeSlots.find(id);
+    return it != _runtimeSlots.end() ? _resources[it->second].get() : nullptr;
+}
+
+Resource* ResourceManager::GetManifestResource(uint32_t slot)
+{
+    auto& resource = _resources[slot];
+    if (resource)
+        return resource.get();
+
+    const auto& entry = _manifest->GetEntry(slot);
+    auto path = std::string{_manifest->GetString(entry.path)};
+    auto type = std::string{_manifest->GetString(entry.type)};
+
+    auto builder = _builders.find(type);
+    if (builder == _builders.end())
+    {
+        throw std::runtime_error("Could not find a builder!");
+    }
+
+    auto properties = _manifest->GetProperties(slot);
+
+    std::vector<ResourceId> dependencies;
+    for (const auto& dependency : properties.value("Dependencies", nlohmann::json::array()))
+        dependencies.emplace_back(dependency.get<std::string>());
+
+    resource = builder->second->BuildResource(this, type, path, properties);
+    resource->SetDependencies(std::move(dependencies));
+    resource->SetType(type);
+    resource->SetPath(path);
+    resource->SetLoadOp(ResourceLoadOp::eFile);
+    resource->SetState(ResourceState::eUnloaded);
+
+    return resource.get();
+}
+
+void ResourceManager::MountPack(const std::filesystem::path& pack)
+{
+    _packs.push_back(std::make_unique<ResourcePack>(pack));
+}
+
+ResourceData ResourceManager::Read(const std::filesystem::path& path)
+{
+    auto name = path.generic_string();
+    LoadTraceScope trace(_tracer, path, LoadPhase::eRead);
+
+    bool reloaded = false;
+    {
+        std::lock_guard lock(_reloadedMutex);
+        reloaded = _reloaded.contains(name);
+    }
+
+    // Rebaked files are copied, the next rebake rewrites them while a mapping would still be in use.
+    if (reloaded)
+        return Decompress(path, _fileSystem->Read(_root / path, true));
+
+    std::unordered_map<std::string, ResourceData>::node_type batched;
+    {
+        std::lock_guard lock(_batchedMutex);
+        batched = _batched.extract(name);
+    }
+
+    if (batched)
+        return Decompress(path, std::move(batched.mapped()));
+
+    // Packs mounted later take priority, so a patch pack can override a base pack.
+    auto hash = Hash64(name);
+    for (auto it = _packs.rbegin(); it != _packs.rend(); it++)
+    {
+        if (const auto* entry = (*it)->FindEntry(hash))
+        {
+            auto payload = (*it)->GetPayload(*entry);
+            return (entry->flags & PackEntryCompressed) ? Decompress(path, payload) : ResourceData{payload};
+        }
+    }
+
+    if (!std::filesystem::is_regular_file(_root / path))
+        throw std::runtime_error("Could not open resource file: " + name);
+
+    // Loose files aren't flagged like pack entries, a compressed one is known by its header.
+    return Decompress(path, _fileSystem->Read(_root / path));
+}
+
+ResourceData ResourceManager::Decompress(const std::filesystem::path& path, ResourceData data)
+{
+    if (!IsCompressed(data.GetSpan()))
+        return data;
+
+    LoadTraceScope trace(_tracer, path, LoadPhase::eDecompress);
+    return ResourceData{bl::Decompress(data.GetSpan(), &_workers)};
+}
+
+void ResourceManager::EnableHotReload()
+{
+    try
+    {
+        _hotReload = std::make_unique<HotReloadSocket>(_root / HotReloadSocketName);
+        blInfo("Listening for rebaked resources on {}.", (_root / HotReloadSocketName).string());
+    }
+    catch (const std::exception& e)
+    {
+        blWarning("Hot reloading is off, {}", e.what());
+    }
+}
+
+void ResourceManager::PollHotReload()
+{
+    if (!_hotReload)
+        return;
+
+    auto paths = _hotReload->Receive();
+    if (paths.empty())
+        return;
+
+    // Every builder gets the chance to let its resources go idle before any are replaced.
+    for (auto* builder : GetBuilders())
+        builder->BeforeUnload();
+
+    for (const auto& path : paths)
+    {
+        try
+        {
+            Reload(path);
+        }
+        catch (const std::exception& e)
+        {
+            blError("Could not reload {}: {}", path, e.what());
+        }
+    }
+}
+
+void ResourceManager::Reload(const std::string& path)
+{
+    auto* resource = FindResource(path);
+    if (!resource)
+    {
+        blWarning("Rebaked resource {} isn't in the manifest, restart to pick it up.", path);
+        return;
+    }
+
+    // A load in flight may have read the old file already, it's finished first and replaced below.
+    if (_loading.contains(resource))
+        LoadResource(resource);
+
+    {
+        std::lock_guard lock(_reloadedMutex);
+        _reloaded.insert(path);
+    }
+
+    // Unloaded resources read the new file whenever they're next loaded.
+    if (resource->GetState() != ResourceState::eLoaded)
+        return;
+
+    resource->Unload();
+    LoadNow(resource);
+
+    for (const auto& callback : _reloadCallbacks)
+        callback(resource);
+
+    blInfo("Reloaded {}.", path);
+}
+
+void ResourceManager::AddReloadCallback(std::function<void(Resource*)> callback)
+{
+    _reloadCallbacks.push_back(std::move(callback));
+}
+
+std::vector<Resource*> ResourceManager::GetLoadOrder(Resource* root)
+{
+    std::vector<Resource*> order;
+    std::unordered_set<Resource*> visited;
+    std::vector<Resource*> path; // Resources being visited, seeing one of them again is a cycle.
+
+    std::function<void(Resource*)> visit = [&](Resource* resource){
+        if (std::find(path.begin(), path.end(), resource) != path.end())
+            throw std::runtime_error("Could not load " + root->GetPath().generic_string() + ", " + resource->GetPath().generic_string() + " depends on itself!");
+
+        if (!visited.insert(resource).second)
+            return;
+
+        path.push_back(resource);
+        for (auto id : resource->GetDependencies())
+        {
+            auto* dependency = FindResource(id);
+            if (!dependency)
+                throw std::runtime_error("Could not load " + resource->GetPath().generic_string() + ", a dependency of it isn't in the manifest!");
+
+            visit(dependency);
+        }
+
+        path.pop_back();
+        order.push_back(resource);
+    };
+
+    visit(root);
+    return order;
+}
+
+std::shared_ptr<AsyncLoad> ResourceManager::BeginLoad(Resource* root)
+{
+    return BeginLoads({&root, 1}).front();
+}
+
+std::vector<std::shared_ptr<AsyncLoad>> ResourceManager::BeginLoads(std::span<Resource* const> roots)
+{
+    // Every read goes out at once, dependencies only hold back when each is finished.
+    std::unordered_map<Resource*, std::shared_ptr<AsyncLoad>> loads;
+    std::vector<std::shared_ptr<AsyncLoad>> started;
+
+    for (auto* root : roots)
+    {
+        for (auto* resource : GetLoadOrder(root))
+        {
+            if (loads.contains(resource))
+                continue;
+
+            if (auto loading = _loading.find(resource); loading != _loading.end())
+            {
+                loads[resource] = loading->second;
+                continue;
+            }
+
+            // Loaded ones get a finished load too, its reference keeps them from being evicted before their dependents finish.
+            auto load = std::make_shared<AsyncLoad>(resource);
+            loads[resource] = load;
+
+            if (resource->GetState() == ResourceState::eLoaded)
+            {
+                load->_state = AsyncLoadState::eLoaded;
+                continue;
+            }
+
+            for (auto id : resource->GetDependencies())
+            {
+                if (auto dependency = loads.find(FindResource(id)); dependency != loads.end())
+                    load->_dependencies.push_back(dependency->second);
+            }
+
+            _loading[resource] = load;
+            started.push_back(load);
+        }
+    }
+
+    // The batch is queued first, a loader thread waiting on it never holds it up.
+    ReadBatch(started);
+
+    for (const auto& load : started)
+        load->_read = _loaders.Submit([this, load](){ ReadAsync(load); }).share();
+
+    std::vector<std::shared_ptr<AsyncLoad>> rootLoads;
+    for (auto* root : roots)
+        rootLoads.push_back(loads.at(root));
+
+    return rootLoads;
+}
+
+void ResourceManager::ReadBatch(const std::vector<std::shared_ptr<AsyncLoad>>& loads)
+{
+    if (!_fileSystem->CanBatch())
+        return;
+
+    std::vector<std::shared_ptr<AsyncLoad>> batched;
+    std::vector<std::filesystem::path> paths;
+    std::vector<std::string> names;
+
+    for (const auto& load : loads)
+    {
+        auto name = load->GetResource()->GetPath().generic_string();
+
+        // Only what Read would read as a loose file, packed ones are already mapped.
+        auto hash = Hash64(name);
+        bool packed = std::any_of(_packs.begin(), _packs.end(), [&](const auto& pack){ return pack->FindEntry(hash) != nullptr; });
+        if (packed || !std::filesystem::is_regular_file(_root / name))
+            continue;
+
+        {
+            std::lock_guard lock(_reloadedMutex);
+            if (_reloaded.contains(name))
+                continue;
+        }
+
+        batched.push_back(load);
+        paths.push_back(_root / name);
+        names.push_back(std::move(name));
+    }
+
+    if (paths.size() < 2)
+        return;
+
+    auto batch = _loaders.Submit([this, paths = std::move(paths), names = std::move(names)](){
+        LoadTraceScope trace(_tracer, {}, LoadPhase::eRead);
+
+        try
+        {
+            auto data = _fileSystem->ReadMany(paths);
+
+            std::lock_guard lock(_batchedMutex);
+            for (size_t i = 0; i < names.size(); i++)
+                _batched.insert_or_assign(names[i], std::move(data[i]));
+        }
+        catch (const std::exception& e)
+        {
+            // Each load reads its own file instead, and fails with its own error.
+            blWarning("Could not read a batch of {} loose files, {}", names.size(), e.what());
+        }
+    }).share();
+
+    for (const auto& load : batched)
+        load->_batch = batch;
+}
+
+void ResourceManager::ReadAsync(const std::shared_ptr<AsyncLoad>& load)
+{
+    // Even a cancelled load waits, its file is only dropped once the batch has put it there.
+    if (load->_batch.valid())
+        load->_batch.wait();
+
+    if (!load->_cancelled)
+    {
+        load->_state = AsyncLoadState::eReading;
+
+        try
+        {
+            LoadTraceScope trace(_tracer, load->_resource->GetPath(), LoadPhase::eDecode);
+            load->_resource->LoadData();
+            load->_state = AsyncLoadState::eFinishing;
+        }
+        catch (const std::exception& e)
+        {
+            load->_error = e.what();
+            load->_state = AsyncLoadState::eFailed;
+        }
+    }
+
+    // Whatever of the batch the load didn't read, it threw or was cancelled first.
+    if (load->_batch.valid())
+    {
+        std::lock_guard lock(_batchedMutex);
+        _batched.erase(load->GetResource()->GetPath().generic_string());
+    }
+
+    // Failed reads are queued too, the render thread unloads whatever was read before the throw.
+    std::lock_guard lock(_finishingMutex);
+    _finishing.push_back(load);
+}
+
+void ResourceManager::Finish(AsyncLoad& load)
+{
+    auto* resource = load.GetResource();
+
+    if (load._cancelled)
+    {
+        resource->Unload();
+        load._state = AsyncLoadState::eCancelled;
+        return;
+    }
+
+    for (const auto& dependency : load._dependencies)
+    {
+        auto state = dependency->GetState();
+        if (load._state != AsyncLoadState::eFailed && (state == AsyncLoadState::eFailed || state == AsyncLoadState::eCancelled))
+        {
+            load._error = "Its dependency " + dependency->GetResource()->GetPath().generic_string() + " could not be loaded.";
+            load._state = AsyncLoadState::eFailed;
+        }
+    }
+
+    load._dependencies.clear();
+
+    if (load._state != AsyncLoadState::eFailed)
+    {
+        try
+        {
+            {
+                LoadTraceScope trace(_tracer, resource->GetPath(), LoadPhase::eUpload);
+                resource->FinishLoad();
+            }
+
+            HoldDependencies(resource);
+            return;
+        }
+        catch (const std::exception& e)
+        {
+            load._error = e.what();
+        }
+    }
+
+    resource->Unload();
+    load._state = AsyncLoadState::eFailed;
+    blError("Could not load {}: {}", resource->GetPath().string(), load._error);
+}
+
+void ResourceManager::FinishLoads()
+{
+    std::vector<std::shared_ptr<AsyncLoad>> finishing;
+    {
+        std::lock_guard lock(_finishingMutex);
+
+        // Taken in topological order, a load waits for a later frame while any dependency is still reading.
+        std::unordered_set<AsyncLoad*> taken;
+        for (bool progress = true; progress;)
+        {
+            progress = false;
+            for (const auto& load : _finishing)
+            {
+                if (taken.contains(load.get()))
+                    continue;
+
+                bool ready = std::all_of(load->_dependencies.begin(), load->_dependencies.end(), [&](const auto& dependency){
+                    return dependency->IsDone() || taken.contains(dependency.get());
+                });
+
+                if (!ready)
+                    continue;
+
+                taken.insert(load.get());
+                finishing.push_back(load);
+                progress = true;
+            }
+        }
+
+        std::erase_if(_finishing, [&](const auto& load){ return taken.contains(load.get()); });
+    }
+
+    if (finishing.empty())
+        return;
+
+    // One submission and one wait for every upload of the frame, instead of one each.
+    auto builders = GetBuilders();
+    for (auto* builder : builders)
+        builder->BeginUploads();
+
+    for (auto& load : finishing)
+        Finish(*load);
+
+    SubmitUploads(builders);
+
+    // Callbacks may start new loads, nothing below touches _loading after them.
+    for (auto& load : finishing)
+        _loading.erase(load->GetResource());
+
+    for (auto& load : finishing)
+        load->SetLoaded();
+}
+
+void ResourceManager::LoadGroup(const std::string& name)
+{
+    if (_groups.contains(name))
+        return;
+
+    auto group = _manifest ? _manifest->FindGroup(name) : std::nullopt;
+    if (!group)
+    {
+        throw std::runtime_error("Could not load an unavailable group: " + name);
+    }
+
+    auto members = _manifest->GetGroupMembers(*group);
+
+    // The group is one run of the pack, reading it in one go beats faulting it in a page
+    // at a time as each resource touches its own part.
+    for (const auto& pack : _packs)
+    {
+        uint64_t begin = UINT64_MAX;
+        uint64_t end = 0;
+
+        for (auto slot : members)
+        {
+            if (const auto* entry = pack->FindEntry(_manifest->GetEntry(slot).pathHash))
+            {
+                begin = std::min(begin, entry->offset);
+                end = std::max(end, entry->offset + entry->size);
+            }
+        }
+
+        if (begin < end)
+            pack->Prefetch(begin, end - begin);
+    }
+
+    std::vector<ResourceRef<Resource>> references;
+    std::vector<Resource*> roots;
+    std::vector<Resource*> order;
+    std::unordered_set<Resource*> ordered;
+
+    for (auto slot : members)
+    {
+        auto* resource = GetManifestResource(slot);
+        references.emplace_back(resource);
+        roots.push_back(resource);
+    }
+
+    // Loose members and dependencies are read in one batch, like the pack's run above.
+    BeginLoads(roots);
+
+    for (auto* resource : roots)
+    {
+        for (auto* dependency : GetLoadOrder(resource))
+        {
+            if (ordered.insert(dependency).second)
+                order.push_back(dependency);
+        }
+    }
+
+    // Every upload of the group goes in one submission, like a frame of FinishLoads.
+    auto builders = GetBuilders();
+    for (auto* builder : builders)
+        builder->BeginUploads();
+
+    for (auto* resource : order)
+    {
+        try
+        {
+            FinishResource(resource);
+        }
+        catch (const std::exception& e)
+        {
+            blError("Could not load {} of group {}: {}", resource->GetPath().string(), name, e.what());
+        }
+    }
+
+    SubmitUploads(builders);
+
+    _groups[name] = std::move(references);
+    blVerbose("Loaded group {} of {} resources.", name, members.size());
+}
+
+void ResourceManager::UnloadGroup(const std::string& name)
+{
+    auto it = _groups.find(name);
+    if (it == _groups.end())
+        return;
+
+    std::vector<Resource*> order;
+    std::unordered_set<Resource*> ordered;
+    for (const auto& resource : it->second)
+    {
+        for (auto* dependency : GetLoadOrder(resource.Get()))
+        {
+            if (ordered.insert(dependency).second)
+                order.push_back(dependency);
+        }
+    }
+
+    _groups.erase(it);
+
+    // Dependents go first, unloading one lets go of its dependencies before they're looked at.
+    bool idle = false;
+    for (auto resource = order.rbegin(); resource != order.rend(); resource++)
+    {
+        if ((*resource)->GetLoadOp() == ResourceLoadOp::ePersistent || !IsUnreferenced(*resource))
+            continue;
+
+        if (!idle)
+        {
+            for (auto* builder : GetBuilders())
+                builder->BeforeUnload();
+
+            idle = true;
+        }
+
+        (*resource)->Unload();
+        (*resource)->_heldDependencies.clear();
+        blVerbose("Unloaded {}.", (*resource)->GetPath().string());
+    }
+}
+
+void ResourceManager::LoadResource(Resource* resource)
+{
+    bool loaded = resource->GetState() == ResourceState::eLoaded && !_loading.contains(resource);
+    if (loaded || resource->GetDependencies().empty())
+    {
+        FinishResource(resource);
+        return;
+    }
+
+    // Reads of the whole closure overlap, only finishing them waits on each in turn.
+    auto order = GetLoadOrder(resource);
+    BeginLoad(resource);
+
+    for (auto* dependency : order)
+        FinishResource(dependency);
+}
+
+void ResourceManager::FinishResource(Resource* resource)
+{
+    auto it = _loading.find(resource);
+    if (it == _loading.end())
+    {
+        if (resource->GetState() != ResourceState::eLoaded)
+        {
+            LoadNow(resource);
+            HoldDependencies(resource);
+        }
+
+        resource->_lastUsed = std::chrono::steady_clock::now();
+        return;
+    }
+
+    // Finished outside of any batch, the caller needs the resource now.
+    auto load = it->second;
+    load->_read.wait();
 
-    for (const auto& data : resources)
     {
-        auto path = data["Path"].get<std::string>();
-        auto type = data["Type"].get<std::string>();
+        std::lock_guard lock(_finishingMutex);
+        std::erase(_finishing, load);
+    }
+
+    Finish(*load);
+    _loading.erase(resource);
+    load->SetLoaded();
+
+    // A cancelled load left it unloaded, a failed one throws again here.
+    if (resource->GetState() != ResourceState::eLoaded)
+    {
+        LoadNow(resource);
+        HoldDependencies(resource);
+    }
+
+    resource->_lastUsed = std::chrono::steady_clock::now();
+}
 
-        auto builder = _builders.find(type);
-        if (builder == _builders.end())
+void ResourceManager::LoadNow(Resource* resource)
+{
+    // Load() is LoadData() then FinishLoad() for every resource, split up here so both phases are traced.
+    try
+    {
         {
-            throw std::runtime_error("Could not find a builder!");
+            LoadTraceScope trace(_tracer, resource->GetPath(), LoadPhase::eDecode);
+            resource->LoadData();
         }
 
-        auto resource = builder->second->BuildResource(this, type, path, data);
-        resource->SetPath(path);
-        resource->SetLoadOp(ResourceLoadOp::eFile);
-        resource->SetState(ResourceState::eUnloaded);
+        LoadTraceScope trace(_tracer, resource->GetPath(), LoadPhase::eUpload);
+        resource->FinishLoad();
+    }
+    catch (...)
+    {
+        resource->Unload();
+        throw;
+    }
+}
+
+void ResourceManager::SubmitUploads(const std::set<ResourceBuilder*>& builders)
+{
+    LoadTraceScope trace(_tracer, {}, LoadPhase::eSubmit);
+
+    for (auto* builder : builders)
+        builder->EndUploads();
+}
+
+void ResourceManager::HoldDependencies(Resource* resource)
+{
+    resource->_heldDependencies.clear();
+    for (auto id : resource->GetDependencies())
+        resource->_heldDependencies.emplace_back(FindResource(id));
+}
+
+std::set<ResourceBuilder*> ResourceManager::GetBuilders() const
+{
+    std::set<ResourceBuilder*> builders;
+    for (const auto& [type, builder] : _builders)
+        builders.insert(builder);
+
+    return builders;
+}
+
+bool ResourceManager::IsUnreferenced(Resource* resource) const
+{
+    return !_loading.contains(resource) && resource->GetState() == ResourceState::eLoaded && resource->GetReferenceCount() == 0;
+}
+
+void ResourceManager::UnloadResources(const std::vector<Resource*>& resources)
+{
+    if (resources.empty())
+        return;
 
-        _resources[path] = std::move(resource);
+    for (auto* builder : GetBuilders())
+        builder->BeforeUnload();
+
+    for (auto* resource : resources)
+    {
+        resource->Unload();
+        resource->_heldDependencies.clear();
+        blVerbose("Unloaded {}.", resource->GetPath().string());
     }
 }
 
 void ResourceManager::UnloadUnreferenced()
 {
+    std::vector<Resource*> unload;
+    std::vector<Resource*> remove;
+
+    for (const auto& resource : _resources)
+    {
+        if (!resource || resource->GetLoadOp() == ResourceLoadOp::ePersistent || _loading.contains(resource.get()) || resource->GetReferenceCount() != 0)
+            continue;
+
+        if (resource->GetState() == ResourceState::eLoaded)
+            unload.push_back(resource.get());
+
+        if (resource->GetLoadOp() == ResourceLoadOp::eRuntime)
+            remove.push_back(resource.get());
+    }
+
+    UnloadResources(unload);
+
+    // Runtime resources have no file to be loaded from again.
+    std::erase_if(_runtimeSlots, [&](const auto& runtime){
+        auto& resource = _resources[runtime.second];
+        if (std::find(remove.begin(), remove.end(), resource.get()) == remove.end())
+            return false;
+
+        resource.reset();
+        _freeSlots.push_back(runtime.second);
+        return true;
+    });
+}
+
+void ResourceManager::SetBudget(const std::string& type, ResourceBudget budget)
+{
+    _budgets[type] = budget;
+}
+
+ResourceMemory ResourceManager::GetMemoryUsage(const std::string& type) const
+{
+    ResourceMemory total;
+    for (const auto& resource : _resources)
+    {
+        if (!resource || resource->GetType() != type || resource->GetState() != ResourceState::eLoaded || _loading.contains(resource.get()))
+            continue;
+
+        auto memory = resource->GetMemoryUsage();
+        total.cpuBytes += memory.cpuBytes;
+        total.gpuBytes += memory.gpuBytes;
+    }
+
+    return total;
+}
+
+void ResourceManager::EnforceBudgets()
+{
+    auto now = std::chrono::steady_clock::now();
+
+    struct TypeUsage
+    {
+        ResourceMemory used;
+        std::vector<Resource*> candidates;
+    };
+
+    std::unordered_map<std::string, TypeUsage> usage;
+
+    // Whatever's referenced right now is in use, that's what keeps it recently used.
+    for (const auto& resource : _resources)
+    {
+        if (!resource || _loading.contains(resource.get()) || resource->GetState() != ResourceState::eLoaded)
+            continue;
+
+        if (resource->GetReferenceCount() > 0)
+            resource->_lastUsed = now;
+
+        if (!_budgets.contains(resource->GetType()))
+            continue;
+
+        auto& type = usage[resource->GetType()];
+        auto memory = resource->GetMemoryUsage();
+        type.used.cpuBytes += memory.cpuBytes;
+        type.used.gpuBytes += memory.gpuBytes;
+
+        if (resource->GetLoadOp() == ResourceLoadOp::eFile && IsUnreferenced(resource.get()))
+            type.candidates.push_back(resource.get());
+    }
+
+    std::vector<Resource*> evict;
+
+    for (auto& [name, type] : usage)
+    {
+        const auto& budget = _budgets.at(name);
+        auto isOver = [&](){ return type.used.cpuBytes > budget.cpuBytes || type.used.gpuBytes > budget.gpuBytes; };
+
+        if (!isOver())
+            continue;
+
+        std::sort(type.candidates.begin(), type.candidates.end(), [](Resource* a, Resource* b){
+            return a->_lastUsed < b->_lastUsed;
+        });
+
+        for (auto* resource : type.candidates)
+        {
+            if (!isOver())
+                break;
+
+            auto memory = resource->GetMemoryUsage();
+            type.used.cpuBytes -= memory.cpuBytes;
+            type.used.gpuBytes -= memory.gpuBytes;
+            evict.push_back(resource);
+        }
+    }
 
+    UnloadResources(evict);
 }
 
 } // namespace bl
\ No newline at end of file
@@ -2,7 +2,15 @@
 
 
 #include "Precompiled.h"
+#include "Core/ThreadPool.h"
+#include "AsyncLoad.h"
+#include "FileSystem.h"
+#include "HotReload.h"
+#include "LoadTrace.h"
+#include "Manifest.h"
 #include "Resource.h"
+#include "ResourceId.h"
+#include "ResourcePack.h"
 
 #include <nlohmann/json.hpp>
 
@@ -16,6 +24,16 @@ public:
     virtual ~ResourceBuilder() = default;
 
     virtual std::unique_ptr<Resource> BuildResource(ResourceManager* manager, const std::string& type, const std::filesystem::path& path, const nlohmann::json& data) = 0;
+    virtual void BeforeUnload() {} /** @brief Called before loaded resources are evicted or reloaded in place, builders whose resources may still be in use elsewhere wait for them here. */
+    virtual void BeginUploads() {} /** @brief Called before ResourceManager::FinishLoads finishes a frame's loads, builders start batching their uploads here. */
+    virtual void EndUploads() {} /** @brief Submits the batched uploads, every finished load is usable once it returns. */
+};
+
+/** @brief Most a type of resource may hold before unreferenced ones are evicted, unlimited by default. */
+struct ResourceBudget
+{
+    std::size_t cpuBytes = SIZE_MAX;
+    std::size_t gpuBytes = SIZE_MAX;
 };
 
 class ResourceManager
@@ -25,36 +43,103 @@ public:
     ~ResourceManager();
 
     void RegisterBuilder(std::vector<std::string> types, ResourceBuilder* builder); /** @brief Registers a builder object to create resource references. */
-    void LoadFromManifest(const std::filesystem::path& manifest);
-    template<typename T> ResourceRef<T> Load(const std::string& path); /** @brief Loads any resource that isn't currently loaded into memory, just returns it if it already exists. */
+    void SetFileSystem(std::unique_ptr<FileSystem> fileSystem); /** @brief Reads manifests and loose files through another backend, call before LoadFromManifest. Memory mapped by default. */
+    FileSystem& GetFileSystem(); /** @brief The backend's read counters are how one deployment's I/O is compared with another's. */
+    LoadTracer& GetLoadTracer(); /** @brief Spans of every load's read, decode and upload, to find out which of them makes a load slow. */
+    void LoadFromManifest(const std::filesystem::path& manifest); /** @brief Maps a binary manifest and mounts its packs, resources are built when they're first looked up. A JSON manifest works too but is parsed. */
+    void MountPack(const std::filesystem::path& pack); /** @brief Maps a resource pack, resources found in it are read without copying. */
+    ResourceData Read(const std::filesystem::path& path); /** @brief Reads a resource file from the mounted packs, falling back to a loose file next to the manifest. Compressed ones are decompressed on the worker pool, so never call it from one of its jobs. */
+    template<typename T> ResourceRef<T> Load(ResourceId id); /** @brief Loads any resource that isn't currently loaded into memory along with its dependencies, just returns it if it already exists. */
+    template<typename T> AsyncLoadHandle<T> LoadAsync(ResourceId id); /** @brief Reads and decodes a resource and its dependencies on loader threads at once, FinishLoads uploads them dependencies first. Throws if the path isn't in the manifest. */
+    void FinishLoads(); /** @brief Finishes every load that's done reading in one batch of uploads, then calls their ready callbacks. Call once a frame on the render thread. */
+    void LoadGroup(const std::string& name); /** @brief Loads a manifest group with one sequential read of its part of the pack, one batched read of its loose files and one batch of uploads. It stays loaded until UnloadGroup. */
+    void UnloadGroup(const std::string& name); /** @brief Lets go of a loaded group, whatever of it nothing else references is unloaded right away. */
     void UnloadUnreferenced(); /** @brief Cleans up memory by unloading resources that aren't currently needed. Abides by a ResourceLoadOp. */
+    void SetBudget(const std::string& type, ResourceBudget budget); /** @brief Limits what loaded resources of a manifest type may hold, enforced by EnforceBudgets. */
+    ResourceMemory GetMemoryUsage(const std::string& type) const; /** @brief What loaded resources of a type hold right now. */
+    void EnforceBudgets(); /** @brief Unloads unreferenced file resources of each type over its budget, least recently used first. Call once a frame on the render thread. */
     template<typename T> ResourceRef<T> AddRuntimeResource(const std::string& path, const std::string& type, const nlohmann::json& data);
+    ThreadPool& GetWorkerPool(); /** @brief Splits the work of a single load across cores, jobs must never wait on other jobs of the pool. */
+
+    void EnableHotReload(); /** @brief Listens for resources the asset processor rebakes in --watch mode, call after LoadFromManifest. */
+    void PollHotReload(); /** @brief Reloads every resource rebaked since the last poll, call once a frame outside of rendering. */
+    void Reload(const std::string& path); /** @brief Reloads a loaded resource in place from its loose file, references to it stay valid. */
+    void AddReloadCallback(std::function<void(Resource*)> callback); /** @brief Called after a resource is reloaded, for anything that holds onto what the resource created. */
 
 private:
+    std::set<ResourceBuilder*> GetBuilders() const; /** @brief Every registered builder once, even those building several types. */
+    Resource* FindResource(ResourceId id); /** @brief Builds a manifest resource the first time it's looked up, null if there's no such resource. */
+    Resource* GetManifestResource(uint32_t slot); /** @brief Builds the resource in a manifest slot the first time it's asked for. */
+    std::vector<Resource*> GetLoadOrder(Resource* root); /** @brief The resource and everything it depends on, each after its own dependencies. Throws on a cycle or a missing dependency. */
+    std::shared_ptr<AsyncLoad> BeginLoad(Resource* root); /** @brief Starts reading whatever of the resource and its dependencies isn't loaded or loading yet. */
+    std::vector<std::shared_ptr<AsyncLoad>> BeginLoads(std::span<Resource* const> roots); /** @brief BeginLoad of several resources, the loose files of all of their loads go in one batch. */
+    void ReadBatch(const std::vector<std::shared_ptr<AsyncLoad>>& loads); /** @brief Reads the loads' loose files with one FileSystem::ReadMany on a loader thread if the backend batches, Read hands each its file. */
+    void ReadAsync(const std::shared_ptr<AsyncLoad>& load); /** @brief The loader thread's part of a load, queues it to be finished either way. */
+    void Finish(AsyncLoad& load); /** @brief Runs Resource::FinishLoad, unloading the resource again if the load failed or was cancelled. */
+    void LoadResource(Resource* resource); /** @brief Blocking load of a resource and its dependencies, their reads still go out in parallel. */
+    void FinishResource(Resource* resource); /** @brief Blocking load of just the resource, a load already in flight is waited for and finished right away. */
+    void LoadNow(Resource* resource); /** @brief Both halves of a load on this thread, traced like an asynchronous one. Unloads the resource again if it throws. */
+    void SubmitUploads(const std::set<ResourceBuilder*>& builders); /** @brief Ends a batch of uploads started with BeginUploads. */
+    ResourceData Decompress(const std::filesystem::path& path, ResourceData data); /** @brief Decompresses a compressed payload's chunks at once on the worker pool, anything else is returned as is. */
+    void HoldDependencies(Resource* resource); /** @brief Once loaded, references its dependencies so they stay loaded as long as it does. */
+    bool IsUnreferenced(Resource* resource) const; /** @brief Loaded, nothing holds a reference and no load of it is in flight. */
+    void UnloadResources(const std::vector<Resource*>& resources); /** @brief Lets the builders go idle first, only if there's anything to unload. */
+
     std::multimap<std::string, ResourceBuilder*> _builders; /** @brief These builders build the resources inside the engine, some builders can build more than one type of resource hence a multimap. */
-    std::unordered_map<std::string, std::unique_ptr<Resource>> _resources;
+    std::unique_ptr<Manifest> _manifest;
+    std::vector<std::unique_ptr<Resource>> _resources; /** @brief Manifest resources in their manifest slots, null until they're first looked up. Runtime resources come after them. */
+    std::unordered_map<ResourceId, uint32_t> _runtimeSlots;
+    std::vector<uint32_t> _freeSlots; /** @brief Left by removed runtime resources. */
+    std::filesystem::path _root; /** @brief Directory of the loaded manifest, loose resource paths are relative to it. */
+    std::vector<std::unique_ptr<ResourcePack>> _packs;
+    std::unique_ptr<FileSystem> _fileSystem;
+    LoadTracer _tracer;
+    ThreadPool _workers;
+    std::unique_ptr<HotReloadSocket> _hotReload;
+    std::unordered_set<std::string> _reloaded; /** @brief Paths rebaked since they were packed, always read from their loose file. */
+    mutable std::mutex _reloadedMutex; /** @brief Loader threads read while the render thread polls for rebakes. */
+    std::unordered_map<std::string, ResourceData> _batched; /** @brief Loose files read by ReadBatch, taken by the first Read of each. */
+    std::mutex _batchedMutex;
+    std::vector<std::function<void(Resource*)>> _reloadCallbacks;
+    std::unordered_map<Resource*, std::shared_ptr<AsyncLoad>> _loading; /** @brief Loads in flight, until FinishLoads is done with them. */
+    std::vector<std::shared_ptr<AsyncLoad>> _finishing; /** @brief Read by a loader thread, waiting for FinishLoads. */
+    std::unordered_map<std::string, ResourceBudget> _budgets;
+    std::unordered_map<std::string, std::vector<ResourceRef<Resource>>> _groups; /** @brief Loaded groups, their references keep the resources loaded. */
+    std::mutex _finishingMutex;
+    ThreadPool _loaders; /** @brief Whole resource loads, apart from _workers so a load can split its decode up without waiting on its own pool. Last, so it's joined first. */
 };
 
 template<typename T>
-ResourceRef<T> ResourceManager::Load(const std::string& path)
+ResourceRef<T> ResourceManager::Load(ResourceId id)
 {
-    auto it = _resources.find(path);
-    if (it == _resources.end())
+    auto* resource = FindResource(id);
+    if (!resource)
     {
         throw std::runtime_error("Could not load an unavailable resource!");
     }
 
-    auto& resource = it->second;
-    resource->Load();
+    LoadResource(resource);
 
-    return ResourceRef<T>{static_cast<T*>(resource.get())};
+    return ResourceRef<T>{static_cast<T*>(resource)};
+}
+
+template<typename T>
+AsyncLoadHandle<T> ResourceManager::LoadAsync(ResourceId id)
+{
+    auto* resource = FindResource(id);
+    if (!resource)
+    {
+        throw std::runtime_error("Could not load an unavailable resource!");
+    }
+
+    return AsyncLoadHandle<T>{BeginLoad(resource)};
 }
 
 template<typename T>
 ResourceRef<T> ResourceManager::AddRuntimeResource(const std::string& path, const std::string& type, const nlohmann::json& data)
 {
-    auto it = _resource.find(path);
-    if (it != _resources.end())
+    ResourceId id{path};
+    if (FindResource(id))
     {
         throw std::runtime_error("Could not add a runtime resource as the path already exists!");
     }
@@ -66,40 +151,74 @@ ResourceRef<T> ResourceManager::AddRuntimeResource(const std::string& path, cons
     }
 
     auto resource = builder->second->BuildResource(this, type, path, data);
+    resource->SetType(type);
     resource->SetPath(path);
     resource->SetLoadOp(ResourceLoadOp::eRuntime);
     resource->SetState(ResourceState::eUnloaded);
 
-    _resources[path] = std::move(resource);
+    auto* created = resource.get();
+
+    uint32_t slot = (uint32_t)_resources.size();
+    if (!_freeSlots.empty())
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        _resources[slot] = std::move(resource);
+    }
+    else
+    {
+        _resources.push_back(std::move(resource));
+    }
 
-    resource->Load();
+    _runtimeSlots[id] = slot;
 
-    return ResourceRef<T>{static_cast<T*>(resource.get())};
+    created->Load();
+
+    return ResourceRef<T>{static_cast<T*>(created)};
 }
 
 } // namespace bl
 
 /* How a resource manifest file works:
 
-    It's a typical JSON file with data for each resource.
+    It's a typical JSON file with data for each resource, the asset processor writes
+    it next to the baked resources along with Manifest.bman, the same manifest in the
+    binary layout the engine maps (see Resource/ManifestFormat.h).
 
     Each resource itself has some data:
-        type - string
-        path - string       <- used as name in the resource manager 
+        Type - string
+        Path - string       <- used as name in the resource manager 
+        Dependencies - array of paths, optional, loaded before the resource
+
+    Groups are optional too, each names resources that are loaded together with
+    LoadGroup, for example everything a level needs. The asset processor lays each
+    group out in one run of the pack.
+
+    Packs are optional, resources inside of them are read straight out of the mapped
+    pack. Anything not in a pack is a loose file relative to the manifest.
 
     {
-        "resources": [
+        "Packs": [ "Resources.bpak" ],
+        "Resources": [
+            {
+                "Type": "Audio",
+                "Path": "Audio/Music/Taswell.flac"
+            },
             {
-                "type": "sound"
-                "path": "/some/path.wav"
+                "Type": "Model",
+                "Path": "Models/red_fox_skull.bmm",
+                "Dependencies": [ "Textures/Bricks_Albedo.bmt" ]
             },
             {
-                "type": "model",
-                "path": "assets/models/fox.gltf"
+                "Type": "Shader",
+                "Path": "Shaders/Default.vert.spv",
+                "Stage": "Vertex"
             }
+        ],
+        "Groups": [
             {
-                "type": "shader",
-                "path": "assets/shaders/default_unlit.vert"
+                "Name": "Forest",
+                "Resources": [ "Models/red_fox_skull.bmm", "Audio/Music/Taswell.flac" ]
             }
         ]
     }
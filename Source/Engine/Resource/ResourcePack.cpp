@@ -0,0 +1,80 @@
+#include <cstring>
+
+#include "Core/Hash.h"
+#include "ResourcePack.h"
+
+namespace bl
+{
+
+ResourcePack::ResourcePack(const std::filesystem::path& path)
+    : _file(path)
+{
+    auto data = _file.GetData();
+
+    if (data.size() < sizeof(PackHeader))
+        throw std::runtime_error("Resource pack is too small to be valid: " + path.string());
+
+    const auto* header = reinterpret_cast<const PackHeader*>(data.data());
+
+    if (std::memcmp(header->magic, "BPAK", 4) != 0 || header->version != PackVersion)
+        throw std::runtime_error("Resource pack has an invalid header or version: " + path.string());
+
+    if (header->tocOffset % alignof(PackEntry) != 0 ||
+        header->tocOffset + (uint64_t)header->numEntries * sizeof(PackEntry) > data.size())
+        throw std::runtime_error("Resource pack table of contents is out of bounds: " + path.string());
+
+    _entries = {reinterpret_cast<const PackEntry*>(data.data() + header->tocOffset), header->numEntries};
+
+    // Validating once here means lookups never need to bounds check.
+    for (const auto& entry : _entries)
+    {
+        if (entry.offset > data.size() || entry.size > data.size() - entry.offset)
+            throw std::runtime_error("Resource pack entry is out of bounds: " + path.string());
+    }
+}
+
+ResourcePack::~ResourcePack()
+{
+}
+
+const std::filesystem::path& ResourcePack::GetPath() const
+{
+    return _file.GetPath();
+}
+
+std::span<const PackEntry> ResourcePack::GetEntries() const
+{
+    return _entries;
+}
+
+const PackEntry* ResourcePack::FindEntry(uint64_t pathHash) const
+{
+    auto it = std::lower_bound(_entries.begin(), _entries.end(), pathHash,
+        [](const PackEntry& entry, uint64_t hash){ return entry.pathHash < hash; });
+
+    if (it == _entries.end() || it->pathHash != pathHash)
+        return nullptr;
+
+    return &(*it);
+}
+
+std::optional<std::span<const std::byte>> ResourcePack::Find(std::string_view path) const
+{
+    const auto* entry = FindEntry(Hash64(path));
+    if (!entry)
+        return std::nullopt;
+
+    return GetPayload(*entry);
+}
+
+std::span<const std::byte> ResourcePack::GetPayload(const PackEntry& entry) const
+{
+    return _file.GetData().subspan(entry.offset, entry.size);
+}
+
+void ResourcePack::Prefetch(uint64_t offset, uint64_t size) const
+{
+    _file.Prefetch((size_t)offset, (size_t)size);
+}
+
+} // namespace bl
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Precompiled.h"
+#include "Core/MappedFile.h"
+#include "PackFormat.h"
+
+namespace bl
+{
+
+/// @brief A memory mapped resource pack written by the asset processor.
+class ResourcePack : public NonCopyable
+{
+public:
+    ResourcePack(const std::filesystem::path& path); /** @brief Maps the pack and validates its table of contents, throws if it's malformed. */
+    ~ResourcePack();
+
+    const std::filesystem::path& GetPath() const; /** @brief Returns the path the pack was mounted from. */
+    std::span<const PackEntry> GetEntries() const; /** @brief Returns the table of contents, sorted by path hash. */
+    const PackEntry* FindEntry(uint64_t pathHash) const; /** @brief Returns nullptr if no resource in this pack has the hash. */
+    std::optional<std::span<const std::byte>> Find(std::string_view path) const; /** @brief Returns a view straight into the mapped pack, valid for as long as the pack is. Compressed payloads are returned as they're stored. */
+    std::span<const std::byte> GetPayload(const PackEntry& entry) const;
+    void Prefetch(uint64_t offset, uint64_t size) const; /** @brief Starts reading a range of the pack in the background as one sequential read, see MappedFile::Prefetch. */
+
+private:
+    MappedFile _file;
+    std::span<const PackEntry> _entries;
+};
+
+} // namespace bl
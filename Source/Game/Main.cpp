@@ -3,12 +3,12 @@
 #include "Core/Print.h"
 #include "Math/Transform.h"
 #include "Engine/Engine.h"
-#include "Graphics/Model.h"
+#include "Graphics/StaticModel.h"
 #include "Graphics/VulkanShader.h"
 #include "Graphics/VulkanPhysicalDevice.h"
 #include "Graphics/VulkanPipeline.h"
 #include "Graphics/Vertex.h"
-#include "Graphics/Mesh.h"
+#include "Graphics/StaticMesh.h"
 #include "Graphics/Material.h"
 #include "Graphics/VulkanConversions.h"
 #include "Graphics/Texture2D.h"
@@ -44,7 +44,18 @@ int main(int argc, const char** argv)
     bl::Engine engine;
 
     auto resourceMgr = engine.GetResourceManager();
-    resourceMgr->LoadFromManifest("Baked/Manifest.json");
+
+    // Picks how resources are read for this machine, Plain, Mapped (the default) or Uring.
+    if (const char* fileSystem = std::getenv("BLUEMETAL_FILE_SYSTEM"))
+        resourceMgr->SetFileSystem(bl::CreateFileSystem(fileSystem));
+
+    resourceMgr->LoadFromManifest("Baked/Manifest.bman");
+    resourceMgr->EnableHotReload();
+
+    // Everything the game starts with is one group, read from the pack in one go and
+    // uploaded in one batch. The model's texture comes along as its dependency, the
+    // loads further down just return what's loaded.
+    resourceMgr->LoadGroup("Startup");
 
     auto audio = engine.GetAudio();
     auto sound = resourceMgr->Load<bl::Sound>("Audio/Music/Taswell.flac");
@@ -59,7 +70,7 @@ int main(int argc, const char** argv)
 
     auto vert = resourceMgr->Load<bl::VulkanShader>("Shaders/Default.vert.spv");
     auto frag = resourceMgr->Load<bl::VulkanShader>("Shaders/Default.frag.spv");
-    auto model = resourceMgr->Load<bl::Model>("Models/red_fox_skull.bmm");
+    auto model = resourceMgr->Load<bl::StaticModel>("Models/red_fox_skull.bmm");
     auto material = resourceMgr->Load<bl::Material>("Materials/Default.mat");
 
     auto renderer = engine.GetRenderer();
@@ -67,6 +78,7 @@ int main(int argc, const char** argv)
     bl::VulkanPipelineStateInfo psi{};
     psi.rasterizerState.cullMode = VK_CULL_MODE_BACK_BIT;
     psi.stages.shaders = { vert.Get(), frag.Get() };
+    psi.vertexState.SetVertexFormat(model.Get()->GetVertexFormat());
     
     auto window = engine.GetWindow();
     auto vulkanWindow = dynamic_cast<bl::VulkanWindow*>(window);
@@ -117,11 +129,31 @@ int main(int argc, const char** argv)
     object.model = glm::identity<glm::mat4>();
     object.model = glm::translate(object.model, glm::vec3{0.0f, 0.0f, 0.0f});
 
-    auto texture = resourceMgr->Load<bl::Texture2D>("Resources/Textures/Bricks_Albedo.jpg");
+    // Remembers the LOD each mesh was drawn with, so LODs don't flicker between frames.
+    bl::StaticModelInstance modelInstance{};
+    modelInstance.world = object.model;
+
+    auto texture = resourceMgr->Load<bl::Texture2D>("Textures/Bricks_Albedo.bmt");
     auto sampler = bl::VulkanSampler{graphics->GetDevice(), VK_FILTER_LINEAR};
 
     material->SetSampledImage2D("image", &sampler, texture.Get()->GetImage());
 
+    // A reloaded texture has a new image, the material has to point at it again. A
+    // reloaded shader has a new module, the pipeline has to be built from it again.
+    resourceMgr->AddReloadCallback([&](bl::Resource* resource){
+        if (resource == texture.Get())
+            material->SetSampledImage2D("image", &sampler, texture.Get()->GetImage());
+
+        if (material->UsesShader(dynamic_cast<bl::VulkanShader*>(resource))) {
+            try {
+                material->RebuildPipeline();
+            }
+            catch (const std::exception& e) {
+                blError("{}", e.what());
+            }
+        }
+    });
+
     bool firstMouse = true;
     glm::ivec2 lastMouse{};
     glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, -10.0f);
@@ -130,6 +162,7 @@ int main(int argc, const char** argv)
     glm::mat4 view = glm::identity<glm::mat4>();
     float yaw = -90.0f, pitch = 0.0f;
     float walkingSpeed = 9.0f;
+    float fieldOfView = 70.0f;
     bool mouseCaptured = false;
     bool windowFocused = false;
     glm::vec3 direction;
@@ -139,7 +172,7 @@ int main(int argc, const char** argv)
     auto extentf = glm::vec2{(float)extent.width, (float)extent.height};
 
     view = glm::lookAt(cameraPos, cameraPos - cameraFront, cameraUp);
-    auto projection = glm::perspectiveFov(70.0f, extentf.x, extentf.y, 0.1f, 100.0f);
+    auto projection = glm::perspectiveFov(fieldOfView, extentf.x, extentf.y, 0.1f, 100.0f);
 
     bl::GlobalUBO globalUBO = {
         0.0f,
@@ -157,6 +190,9 @@ int main(int argc, const char** argv)
     while (running) 
     {
         frameCounter.BeginFrame();
+        resourceMgr->PollHotReload();
+        resourceMgr->FinishLoads();
+        resourceMgr->EnforceBudgets();
 
         glm::vec2 mouseRelativeMovement = {};
         SDL_Event event;
@@ -247,7 +283,7 @@ int main(int argc, const char** argv)
 
         extent = window->GetExtent();
         extentf = glm::vec2{(float)extent.width, (float)extent.height};
-        projection = glm::perspectiveFov(70.0f, extentf.x, extentf.y, 0.1f, 1000.0f);
+        projection = glm::perspectiveFov(fieldOfView, extentf.x, extentf.y, 0.1f, 1000.0f);
         // auto extentf = glm::vec2{(float)extent.width, (float)extent.height};
 
         globalUBO = {
@@ -305,7 +341,10 @@ int main(int argc, const char** argv)
             material->Bind(rd);
             material->PushConstant(rd, 0, sizeof(bl::ObjectPC), &object);
 
-            model.Get()->Draw(material.get(), rd);
+            // Each mesh is drawn at the coarsest LOD that's within a pixel of full detail from the camera.
+            auto modelView = bl::ModelView::FromPerspective(cameraPos, fieldOfView, (float)extent.height);
+            modelView.frustum = bl::Frustum::FromMatrix(projection * view);
+            model.Get()->Draw(material.get(), rd, modelView, modelInstance);
 
             imgui->BeginFrame();
 
@@ -347,6 +386,12 @@ int main(int argc, const char** argv)
                 ImGui::Text("x: %f, y: %f, z: %f", cameraPos.x, cameraPos.y, cameraPos.z);
             }
 
+            if (ImGui::CollapsingHeader("Model")) {
+                for (size_t i = 0; i < modelInstance.lods.size(); i++)
+                    ImGui::Text("Mesh %zu: LOD %u", i, (uint32_t)modelInstance.lods[i]);
+                ImGui::Text("Meshlets drawn: %u, culled: %u", modelInstance.drawnMeshlets, modelInstance.culledMeshlets);
+            }
+
 
             if (ImGui::CollapsingHeader("Graphics")) {
 
@@ -397,6 +442,49 @@ int main(int argc, const char** argv)
                 }
             }
 
+            if (ImGui::CollapsingHeader("Resources")) {
+                auto& tracer = resourceMgr->GetLoadTracer();
+                auto toMs = [](std::chrono::nanoseconds time){ return std::chrono::duration<double, std::milli>(time).count(); };
+
+                if (ImGui::Button("Save Load Trace")) {
+                    try {
+                        tracer.ExportChromeTrace("LoadTrace.json");
+                        blInfo("Saved the load trace to LoadTrace.json, open it in chrome://tracing or ui.perfetto.dev.");
+                    }
+                    catch (const std::exception& e) {
+                        blError("{}", e.what());
+                    }
+                }
+
+                ImGui::SameLine();
+                if (ImGui::Button("Clear"))
+                    tracer.Clear();
+
+                if (ImGui::BeginTable("Slowest Loads", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                    ImGui::TableSetupColumn("Resource");
+                    ImGui::TableSetupColumn("Loads");
+                    ImGui::TableSetupColumn("Read ms");
+                    ImGui::TableSetupColumn("Decompress ms");
+                    ImGui::TableSetupColumn("Decode ms");
+                    ImGui::TableSetupColumn("Upload ms");
+                    ImGui::TableSetupColumn("Total ms");
+                    ImGui::TableHeadersRow();
+
+                    for (const auto& summary : tracer.GetSlowest(10)) {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn(); ImGui::TextUnformatted(summary.resource.c_str());
+                        ImGui::TableNextColumn(); ImGui::Text("%u", summary.loads);
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", toMs(summary.read));
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", toMs(summary.decompress));
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", toMs(summary.decode));
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", toMs(summary.upload));
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", toMs(summary.GetTotal()));
+                    }
+
+                    ImGui::EndTable();
+                }
+            }
+
             if (ImGui::CollapsingHeader("Audio")) {
                 ImGui::Text("Audio Driver: %s", audio->GetDriverName().c_str());
                 ImGui::Text("Num Channels: %d", audio->GetNumChannelsPlaying());